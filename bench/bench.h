@@ -0,0 +1,22 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+// Minimal timing for the benchmark executables
+
+// Average microseconds per call of `fn` over `iterations` calls. `fn`
+// returns a value that is summed and printed so the work isn't optimised out.
+template <typename Fn>
+double micros_per_call(const char* label, size_t iterations, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    size_t sink = 0;
+    for (size_t i = 0; i < iterations; ++i) sink += static_cast<size_t>(fn());
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+    double per_call = elapsed.count() / static_cast<double>(iterations);
+    std::printf("%-28s %10.2f us/call %12.0f calls/s  (checksum %zu)\n", label, per_call,
+                1e6 / per_call, sink);
+    return per_call;
+}
@@ -0,0 +1,144 @@
+// Heap allocations for one match's text work (tracked-player lists, AI
+// prompts, Discord message), with its scratch memory on the default
+// resource vs in a MatchArena. Network calls and their JSON bodies are left
+// out; they allocate the same either way.
+#include "ai_client.h"
+#include "bench.h"
+#include "discord_client.h"
+#include "match_arena.h"
+#include "match_payloads.h"
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+
+// ============================================================================
+// Global allocation counter
+// ============================================================================
+
+namespace {
+
+size_t g_heap_allocations = 0;
+size_t g_heap_bytes = 0;
+
+void* counted_alloc(size_t size, size_t alignment) {
+    ++g_heap_allocations;
+    g_heap_bytes += size;
+    size = size == 0 ? 1 : size;
+    void* p = alignment <= alignof(std::max_align_t)
+                  ? std::malloc(size)
+                  : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+}  // namespace
+
+// Every replaceable form, including the aligned ones new_delete_resource uses
+void* operator new(size_t size) { return counted_alloc(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size) { return counted_alloc(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, std::align_val_t alignment) {
+    return counted_alloc(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return counted_alloc(size, static_cast<size_t>(alignment));
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+
+// What main.cpp does for a match between the AI and Discord calls
+size_t process_match(const MatchData& match, const TrackedIndex& tracked,
+                     const std::map<SteamId, std::string>& comments, std::pmr::memory_resource* memory) {
+    PlayerViews tracked_players = match.get_tracked_players(tracked, memory);
+    size_t bytes = 0;
+    if (tracked_players.size() > 1) {
+        ArenaOStream prompt(memory);
+        AIClient::build_multi_player_prompt(prompt, match, tracked_players, tracked, memory);
+        ArenaOStream message(memory);
+        DiscordClient::build_multi_player_report(message, match, tracked_players, comments);
+        bytes = prompt.view().size() + message.view().size();
+    } else {
+        ArenaOStream prompt(memory);
+        AIClient::build_comment_prompt(prompt, match, tracked, memory);
+        ArenaOStream message(memory);
+        DiscordClient::build_match_report(message, match, comments.begin()->second);
+        bytes = prompt.view().size() + message.view().size();
+    }
+    return bytes;
+}
+
+struct Counts {
+    size_t allocations;
+    size_t bytes;
+};
+
+template <typename Fn>
+Counts count_heap(Fn fn) {
+    size_t allocations = g_heap_allocations;
+    size_t bytes = g_heap_bytes;
+    fn();
+    return {g_heap_allocations - allocations, g_heap_bytes - bytes};
+}
+
+void measure(const char* label, const MatchData& match, const TrackedIndex& tracked,
+             const std::map<SteamId, std::string>& comments) {
+    // Warm up once so one-off static allocations aren't counted
+    process_match(match, tracked, comments, std::pmr::get_default_resource());
+
+    Counts without = count_heap([&] {
+        process_match(match, tracked, comments, std::pmr::get_default_resource());
+    });
+    size_t served = 0;
+    Counts with = count_heap([&] {
+        MatchArena arena;
+        process_match(match, tracked, comments, arena.resource());
+        served = arena.allocations();
+    });
+    std::printf("%-18s without arena: %4zu heap allocations (%6zu bytes)   "
+                "with arena: %4zu heap allocations (%6zu bytes), %zu served by the arena\n",
+                label, without.allocations, without.bytes, with.allocations, with.bytes, served);
+
+    micros_per_call("  default resource", 20000, [&] {
+        return process_match(match, tracked, comments, std::pmr::get_default_resource());
+    });
+    micros_per_call("  match arena", 20000, [&] {
+        MatchArena arena;
+        return process_match(match, tracked, comments, arena.resource());
+    });
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937 rng(1);
+    std::string body = make_match_payload(rng, 1);
+    std::optional<MatchData> parsed;
+    {
+        QuietLogs quiet;
+        parsed = parse_match_details_extended(std::make_shared<const std::string>(body), "bench");
+    }
+    const MatchData& match = *parsed;
+
+    std::map<SteamId, std::string> comments;
+    for (PlayerRef player : match.players) {
+        comments[player.steam_id()] = "Absolutely carried, the enemies should uninstall.";
+    }
+
+    measure("1 tracked player", match, TrackedIndex({match.players[0].steam_id()}), comments);
+    measure("3 tracked players", match,
+            TrackedIndex({match.players[0].steam_id(), match.players[2].steam_id(), match.players[4].steam_id()}),
+            comments);
+    return 0;
+}
@@ -0,0 +1,36 @@
+// Loading a stored match: binary format vs re-parsing the JSON payload
+#include "bench.h"
+#include "match_binary.h"
+#include "match_payloads.h"
+#include <cstdio>
+#include <random>
+#include <string>
+
+int main() {
+    std::mt19937 rng(1);
+    std::string body = make_match_payload(rng, 1);
+    MatchData match;
+    {
+        QuietLogs quiet;
+        match = parse_match_details_from_json(body, "bench");
+    }
+    std::string encoded = encode_match(match);
+    std::printf("%zu players, json %zu bytes, binary %zu bytes\n", match.players.size(), body.size(),
+                encoded.size());
+
+    constexpr size_t kIterations = 20000;
+    QuietLogs quiet;
+    micros_per_call("json re-parse (SAX)", kIterations, [&] {
+        return parse_match_details_from_json(body, "bench").players.size();
+    });
+    micros_per_call("binary -> MatchData", kIterations, [&] {
+        return MatchView::open(encoded.data(), encoded.size())->to_match_data().players.size();
+    });
+    micros_per_call("binary in place (kills)", kIterations, [&] {
+        std::optional<MatchView> view = MatchView::open(encoded.data(), encoded.size());
+        size_t kills = 0;
+        for (size_t i = 0; i < view->player_count(); ++i) kills += static_cast<size_t>(view->kills(i));
+        return kills;
+    });
+    return 0;
+}
@@ -0,0 +1,42 @@
+// Match detail parsing throughput: DOM reference, SAX, fast path, fast path
+// with extended stats, and the string scan kernels on their own
+#include "bench.h"
+#include "json_scan.h"
+#include "match_payloads.h"
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+
+int main() {
+    std::mt19937 rng(1);
+    std::string body = make_match_payload(rng, 1);
+    auto shared_body = std::make_shared<const std::string>(body);
+    std::printf("%zu byte payload, scan kernel %s\n", body.size(), json_scan_backend());
+
+    constexpr size_t kIterations = 20000;
+    {
+        QuietLogs quiet;
+        micros_per_call("DOM (reference)", kIterations, [&] {
+            return parse_match_details_from_json_dom(body, "bench").players.size();
+        });
+        micros_per_call("SAX", kIterations, [&] {
+            return parse_match_details_from_json(body, "bench").players.size();
+        });
+        micros_per_call("fast", kIterations, [&] {
+            return parse_match_details_fast(body, "bench")->players.size();
+        });
+        micros_per_call("fast + extended stats", kIterations, [&] {
+            return parse_match_details_extended(shared_body, "bench")->players.size();
+        });
+    }
+
+    // A long plain run, as in a large string value
+    std::string run(4096, 'a');
+    run.push_back('"');
+    for (const auto& backend : json_scan_backends()) {
+        std::string label = std::string("scan 4 KiB run (") + backend.name + ")";
+        micros_per_call(label.c_str(), kIterations * 10, [&] { return backend.scan(run.data(), run.size()); });
+    }
+    return 0;
+}
@@ -3,35 +3,51 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory_resource>
+#include <ostream>
+#include <string_view>
 #include "match_data.h"
 
 class AIClient {
 public:
     AIClient(const std::string& api_key);
 
+    // Ask Groq for gzip/deflate-compressed responses
+    void set_compression(bool enabled) { compression_ = enabled; }
+
+    // Prompts are built in `memory` (e.g. the match's MatchArena)
+
     // Generate a funny comment about a match based on player stats
-    std::string generate_match_comment(const MatchData& match,
-                                       const std::vector<std::string>& tracked_steam_ids);
+    std::string generate_match_comment(const MatchData& match, const TrackedIndex& tracked,
+                                       std::pmr::memory_resource* memory = std::pmr::get_default_resource());
 
     // Generate a comment about specific player performance
-    std::string generate_player_comment(const PlayerStats& player, const MatchData& match);
+    std::string generate_player_comment(PlayerRef player, const MatchData& match,
+                                        std::pmr::memory_resource* memory = std::pmr::get_default_resource());
 
     // Generate individual comments for multiple tracked players in one match
     // Returns map of steam_id -> comment
-    std::map<std::string, std::string> generate_multi_player_comments(
+    std::map<SteamId, std::string> generate_multi_player_comments(
         const MatchData& match,
-        const std::vector<PlayerStats>& tracked_players);
+        const PlayerViews& tracked_players,
+        const TrackedIndex& tracked,
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource());
 
-private:
-    std::string api_key_;
+    // The prompts the calls above send (scratch lists are allocated in `memory`)
+    static void build_comment_prompt(std::ostream& prompt, const MatchData& match,
+                                     const TrackedIndex& tracked, std::pmr::memory_resource* memory);
 
-    std::string build_comment_prompt(const MatchData& match,
-                                     const std::vector<std::string>& tracked_steam_ids);
+    static void build_player_prompt(std::ostream& prompt, PlayerRef player, const MatchData& match);
 
-    std::string build_multi_player_prompt(const MatchData& match,
-                                          const std::vector<PlayerStats>& tracked_players);
+    static void build_multi_player_prompt(std::ostream& prompt, const MatchData& match,
+                                          const PlayerViews& tracked_players,
+                                          const TrackedIndex& tracked, std::pmr::memory_resource* memory);
+
+private:
+    std::string api_key_;
+    bool compression_ = false;
 
-    std::string make_api_request(const std::string& prompt);
+    std::string make_api_request(std::string_view prompt);
 };
 
 // Keep old name for compatibility
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Little-endian load/store for the binary formats (integers, bools, doubles).
+// Byte-wise, so they work on any host and on unaligned buffers.
+
+template <typename T>
+void store_le(unsigned char* out, T value) {
+    uint64_t bits = 0;
+    if constexpr (std::is_floating_point_v<T>) {
+        static_assert(sizeof(T) == sizeof(uint64_t), "only double is supported");
+        std::memcpy(&bits, &value, sizeof(bits));
+    } else {
+        bits = static_cast<uint64_t>(static_cast<std::make_unsigned_t<T>>(value));
+    }
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out[i] = static_cast<unsigned char>(bits >> (8 * i));
+    }
+}
+
+template <typename T>
+T load_le(const unsigned char* in) {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        bits |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    if constexpr (std::is_floating_point_v<T>) {
+        static_assert(sizeof(T) == sizeof(uint64_t), "only double is supported");
+        T value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    } else {
+        return static_cast<T>(static_cast<std::make_unsigned_t<T>>(bits));
+    }
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+// gzip-compress a buffer (zlib, default compression level)
+std::string gzip_compress(const std::string& data);
+
+// Inflate a gzip- or zlib-wrapped buffer; nullopt if the data is corrupt
+std::optional<std::string> gzip_decompress(const std::string& data);
+
+// Decode an HTTP body in place according to its Content-Encoding
+// (gzip, deflate or identity). Returns false if it can't be decoded.
+bool decode_content_encoding(std::string& body, const std::string& content_encoding);
@@ -4,6 +4,7 @@
 #include <vector>
 #include <unordered_set>
 #include <map>
+#include "steam_id.h"
 
 struct Config {
     // API Keys
@@ -12,10 +13,30 @@ struct Config {
     std::string openai_api_key;
     
     // Steam IDs to track
-    std::vector<std::string> tracked_steam_ids;
+    std::vector<SteamId> tracked_steam_ids;
     
     // Polling settings
     int poll_interval_seconds = 60;  // Default: poll every 60 seconds
+    int active_poll_interval_seconds = 30;   // Right after a player finished a match
+    int max_poll_interval_seconds = 1800;    // Backoff ceiling for idle players
+    int poll_concurrency = 8;        // Max parallel Leetify requests per cycle
+    int catchup_max_matches = 10;    // Max unseen matches ingested per player per cycle
+    int leetify_requests_per_minute = 0;  // Leetify request budget (0 = unlimited)
+    int leetify_burst = 10;               // Requests allowed back-to-back under the budget
+    int leetify_hedge_percentile = 0;     // Hedge detail fetches slower than this latency percentile (0 = off)
+    
+    // Request gzip/deflate-compressed responses from Leetify, Groq and Discord
+    bool http_compression = false;
+    
+    // Parse match details with the SIMD fast path (nlohmann as fallback)
+    bool fast_json_parser = false;
+    
+    // Add optional per-player stats (MVPs, multi-kills, utility) to prompts
+    bool extended_stats = false;
+    
+    // On-disk cache of finished match details
+    std::string match_cache_dir = "match_cache";
+    int match_cache_max_mb = 64;  // 0 disables the cache
     
     // OpenAI settings
     std::string openai_model = "gpt-3.5-turbo";
@@ -3,22 +3,35 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory_resource>
+#include <ostream>
 #include "match_data.h"
 
 class DiscordClient {
 public:
     DiscordClient(const std::string& webhook_url);
 
+    // Ask Discord for gzip/deflate-compressed responses
+    void set_compression(bool enabled) { compression_ = enabled; }
+
     // Send a simple text message
     bool send_message(const std::string& message);
 
-    // Send a formatted match report
-    bool send_match_report(const MatchData& match, const std::string& comment);
+    // Send a formatted match report (the message is built in `memory`)
+    bool send_match_report(const MatchData& match, const std::string& comment,
+                           std::pmr::memory_resource* memory = std::pmr::get_default_resource());
 
     // Send a match report with individual comments for multiple tracked players
     bool send_multi_player_report(const MatchData& match,
-                                  const std::vector<PlayerStats>& tracked_players,
-                                  const std::map<std::string, std::string>& player_comments);
+                                  const PlayerViews& tracked_players,
+                                  const std::map<SteamId, std::string>& player_comments,
+                                  std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    // The message texts the two reports above send
+    static void build_match_report(std::ostream& message, const MatchData& match, const std::string& comment);
+    static void build_multi_player_report(std::ostream& message, const MatchData& match,
+                                          const PlayerViews& tracked_players,
+                                          const std::map<SteamId, std::string>& player_comments);
 
     // Send a formatted embed with match stats
     bool send_embed(const std::string& title, const std::string& description,
@@ -28,6 +41,7 @@ private:
     std::string webhook_url_;
     std::string webhook_path_;
     std::string base_url_ = "https://discord.com";
+    bool compression_ = false;
 
     std::string escape_json(const std::string& str);
     std::string extract_webhook_path(const std::string& webhook_url);
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "player_fields.h"
+
+/**
+ * The stats[] values a parse doesn't put in the roster (Leetify sends
+ * dozens per player), kept as byte ranges into the raw payload. Ranges are
+ * recorded during the one parse pass; a value is only decoded when a
+ * prompt or report asks for it. Copies share the payload.
+ */
+class ExtendedStats {
+public:
+    ExtendedStats() = default;
+    explicit ExtendedStats(std::shared_ptr<const std::string> body) : body_(std::move(body)) {}
+
+    bool empty() const { return player_begin_.empty(); }
+
+    // Players recorded, in roster order
+    size_t player_count() const { return player_begin_.size(); }
+
+    // Recording (parser side): start the next player's entry, then add its
+    // key/value ranges (offsets into the payload)
+    void begin_player() { player_begin_.push_back(static_cast<uint32_t>(slices_.size())); }
+    void add(size_t key_offset, size_t key_length, size_t value_offset, size_t value_length);
+
+    // Raw JSON text of a player's value (nullopt if the entry has no such key)
+    std::optional<std::string_view> raw(size_t player, std::string_view key) const;
+
+    // Decoded number (nullopt if absent or not a number)
+    std::optional<double> number(size_t player, std::string_view key) const;
+
+private:
+    struct Slice {
+        uint32_t key_offset;
+        uint32_t key_length;
+        uint32_t value_offset;
+        uint32_t value_length;
+    };
+
+    std::shared_ptr<const std::string> body_;
+    std::vector<Slice> slices_;
+    std::vector<uint32_t> player_begin_;  // First slice of each player
+};
+
+// Append the PLAYER_EXTENDED_FIELDS a player has, each preceded by
+// style.separator (meant to follow write_stats), e.g. ", MVPs 3, 3Ks 2"
+void write_extended_stats(std::ostream& out, const ExtendedStats& extended, size_t player,
+                          const StatStyle& style = kInlineStats);
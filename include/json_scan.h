@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Vectorized scanning for the hand-written JSON fast path
+ * (parse_match_details_fast). The implementation is picked once, on first
+ * use, from what the CPU supports: AVX2, SSE2, or plain C++ elsewhere.
+ */
+
+// Length of the plain run of string content at the start of [data, data + size):
+// the index of the first '"', '\\', control character (< 0x20) or non-ASCII
+// byte (>= 0x80), or `size` if there is none
+size_t scan_string_run(const char* data, size_t size);
+
+// Implementation in use: "avx2", "sse2" or "scalar"
+const char* json_scan_backend();
+
+struct JsonScanBackend {
+    size_t (*scan)(const char* data, size_t size);
+    const char* name;
+};
+
+// Every implementation this CPU can run, scalar first (for tests and
+// benchmarks; each must agree with scan_string_run)
+std::vector<JsonScanBackend> json_scan_backends();
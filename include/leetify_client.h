@@ -1,18 +1,99 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
+#include "match_cache.h"
 #include "match_data.h"
+#include "rate_limiter.h"
+
+// Result of a fingerprinted match-list poll
+struct MatchListResult {
+    enum class Status { Ok, Unchanged, Failed };
+
+    Status status = Status::Failed;
+    std::vector<MatchListEntry> entries;  // Only filled when status == Ok
+    std::string newest_id;                // Newest match ID (also set when Unchanged)
+};
 
 class LeetifyClient {
 public:
     LeetifyClient(const std::string& api_key);
+    ~LeetifyClient();
+
+    // Route every request through a (process-wide) limiter; 429s pause it
+    void set_rate_limiter(std::shared_ptr<RateLimiter> limiter) { rate_limiter_ = std::move(limiter); }
+
+    // Ask Leetify for gzip/deflate-compressed responses
+    void set_compression(bool enabled) { compression_ = enabled; }
+
+    // Serve finished match details from (and store them in) an on-disk cache
+    void set_match_cache(std::shared_ptr<MatchCache> cache) { match_cache_ = std::move(cache); }
+
+    // Hedge detail fetches: when no answer has arrived by this percentile of recent
+    // detail latencies, send a second identical request and use whichever answers
+    // first (0 disables hedging)
+    void set_hedging(int percentile) { hedge_percentile_ = percentile; }
+
+    // Parse match details with the hand-written fast path, falling back to
+    // nlohmann for payloads it doesn't accept
+    void set_fast_json(bool enabled) { fast_json_ = enabled; }
+
+    // Also keep every other stats[] value (MatchData::extended) for prompts.
+    // Uses the fast parser; payloads it hands back to nlohmann have none.
+    void set_extended_stats(bool enabled) { extended_stats_ = enabled; }
     
-    // Fetch the most recent match for a Steam ID
-    MatchData fetch_recent_match(const std::string& steam64_id);
+    // Fetch a player's match list, newest first (list endpoint only, no details).
+    // Parsing stops after the first entry `stop_after` accepts.
+    std::vector<MatchListEntry> fetch_recent_matches(SteamId steam64_id,
+                                                     const MatchListStop& stop_after = nullptr);
+
+    // Poll a player's match list, skipping the parse when it is unchanged since
+    // the last poll (ETag / If-None-Match, or a hash of the body as fallback)
+    MatchListResult poll_match_list(SteamId steam64_id,
+                                    const MatchListStop& stop_after = nullptr);
+
+    // Drop a player's list fingerprint so the next poll re-parses the list
+    void forget_list_fingerprint(SteamId steam64_id);
+
+    // Fingerprinted list polls made / answered as unchanged
+    size_t list_polls() const { return list_polls_; }
+    size_t unchanged_list_polls() const { return unchanged_list_polls_; }
+
+    // Fetch the most recent match ID for a Steam ID (list endpoint only, no details)
+    std::string fetch_recent_match_id(SteamId steam64_id);
+
+    // Fetch the most recent match for a Steam ID (list + details); nullptr on failure
+    MatchSnapshot fetch_recent_match(SteamId steam64_id);
     
-    // Fetch detailed match data by match ID
-    MatchData fetch_match_details(const std::string& match_id);
+    // Fetch detailed match data by match ID; nullptr if it couldn't be fetched.
+    // Concurrent and repeated requests for the same match share a single
+    // download (and the same snapshot) until clear_completed_fetches().
+    MatchSnapshot fetch_match_details(const std::string& match_id);
+
+    // Forget finished shared fetches (call once per poll cycle)
+    void clear_completed_fetches();
+
+    // Number of detail requests answered by joining an existing fetch
+    size_t coalesced_fetch_count() const { return coalesced_fetches_; }
+
+    // Detail requests actually sent to Leetify, hedges included (cache hits
+    // and coalesced fetches don't count)
+    size_t detail_requests_sent() const { return detail_requests_sent_; }
+
+    // Hedge requests sent / hedges that answered before the original request
+    size_t hedges_issued() const { return hedges_issued_; }
+    size_t hedges_won() const { return hedges_won_; }
+
+    // Match details parsed by the fast path / handed back to nlohmann
+    size_t fast_parses() const { return fast_parses_; }
+    size_t fast_parse_fallbacks() const { return fast_parse_fallbacks_; }
     
     // Check if API key is valid
     bool is_valid() const;
@@ -20,4 +101,53 @@ public:
 private:
     std::string api_key_;
     std::string base_url_ = "https://api-public.cs-prod.leetify.com";
+    std::shared_ptr<RateLimiter> rate_limiter_;
+    std::shared_ptr<MatchCache> match_cache_;
+    bool compression_ = false;
+    bool fast_json_ = false;
+    bool extended_stats_ = false;
+    std::atomic<size_t> fast_parses_{0};
+    std::atomic<size_t> fast_parse_fallbacks_{0};
+
+    // Single-flight table: match_id -> shared result of the one real fetch
+    std::mutex fetches_mutex_;
+    std::unordered_map<std::string, std::shared_future<MatchSnapshot>> fetches_;
+    std::atomic<size_t> coalesced_fetches_{0};
+    std::atomic<size_t> detail_requests_sent_{0};
+
+    // Per-player fingerprint of the last match-list response
+    struct ListFingerprint {
+        std::string etag;
+        uint64_t body_hash = 0;
+        std::string newest_id;
+    };
+    std::mutex fingerprints_mutex_;
+    std::unordered_map<SteamId, ListFingerprint> fingerprints_;
+    std::atomic<size_t> list_polls_{0};
+    std::atomic<size_t> unchanged_list_polls_{0};
+
+    // Recent detail-fetch latencies (ring buffer) used to pick the hedge delay
+    int hedge_percentile_ = 0;
+    std::mutex latencies_mutex_;
+    std::vector<double> detail_latencies_;
+    size_t next_latency_slot_ = 0;
+    std::atomic<size_t> hedges_issued_{0};
+    std::atomic<size_t> hedges_won_{0};
+
+    // Hedge losers that were cancelled but may still be unwinding
+    struct Straggler {
+        std::thread thread;
+        std::shared_ptr<std::atomic<bool>> done;
+    };
+    std::mutex stragglers_mutex_;
+    std::vector<Straggler> stragglers_;
+
+    void record_detail_latency(double seconds);
+    double hedge_delay_seconds();
+    void park_straggler(Straggler straggler);
+
+    MatchListResult fetch_match_list(SteamId steam64_id, bool use_fingerprint,
+                                     const MatchListStop& stop_after);
+    MatchData download_match_details(const std::string& match_id);
+    MatchData parse_details(std::shared_ptr<const std::string> body, const std::string& match_id);
 };
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include "match_data.h"
+
+/**
+ * Versioned binary encoding of a MatchData that can be read in place.
+ *
+ * Layout (little-endian, every section 8-byte aligned):
+ *   header        magic "CSHMATCH", version, section offsets/counts and
+ *                 string refs for match_id / map_name / game_finished_at
+ *   column dir    {offset, element size} per PLAYER_STAT_FIELDS column
+ *   steam IDs     u64 per player
+ *   columns       one array per stat, in table order
+ *   name refs     {offset, length} into the string table, per player
+ *   team scores   {team_number, score} as i32 pairs
+ *   string table  raw bytes
+ *
+ * Stat columns are append-only: a file written before a stat was added to
+ * the table simply has fewer columns, and MatchView returns the stat's
+ * default for them. Any other layout change bumps kMatchFormatVersion.
+ */
+constexpr uint16_t kMatchFormatVersion = 1;
+
+// Serialize a match into the binary format
+std::string encode_match(const MatchData& match);
+
+/**
+ * Read-only view over an encoded match (e.g. an mmap'd file). open()
+ * validates every offset once; the accessors then read straight from the
+ * buffer without building a MatchData. The buffer must outlive the view.
+ */
+class MatchView {
+public:
+    // nullopt (and a reason in `error`) if the buffer isn't a valid encoding
+    static std::optional<MatchView> open(const void* data, size_t size, std::string* error = nullptr);
+
+    uint16_t version() const { return version_; }
+
+    std::string_view match_id() const { return string_at(match_id_ref_); }
+    std::string_view map_name() const { return string_at(map_name_ref_); }
+    std::string_view game_finished_at() const { return string_at(finished_at_ref_); }
+
+    size_t player_count() const { return player_count_; }
+    SteamId steam_id(size_t player) const;
+    std::string_view name(size_t player) const;
+#define X(member, type, ...) type member(size_t player) const;
+    PLAYER_STAT_FIELDS(X)
+#undef X
+
+    size_t team_count() const { return team_count_; }
+    TeamScore team_score(size_t team) const;
+
+    // Materialize a full MatchData (names are interned like a fresh parse)
+    MatchData to_match_data() const;
+
+private:
+    MatchView() = default;
+
+    std::string_view string_at(uint32_t ref_offset) const;
+
+    template <typename T>
+    T column_value(PlayerStat stat, size_t player, T fallback) const;
+
+    const unsigned char* data_ = nullptr;
+    uint16_t version_ = 0;
+    uint32_t player_count_ = 0;
+    uint32_t team_count_ = 0;
+    uint32_t column_count_ = 0;
+    uint32_t column_dir_ = 0;
+    uint32_t steam_ids_ = 0;
+    uint32_t name_refs_ = 0;
+    uint32_t team_scores_ = 0;
+    uint32_t strings_ = 0;
+    uint32_t match_id_ref_ = 0;
+    uint32_t map_name_ref_ = 0;
+    uint32_t finished_at_ref_ = 0;
+};
+
+// Write an encoded match to `path` (temp file + rename)
+bool write_match_file(const std::string& path, const MatchData& match);
+
+/**
+ * An encoded match file mapped into memory (read into a buffer where mmap
+ * isn't available).
+ */
+class MappedMatchFile {
+public:
+    MappedMatchFile() = default;
+    ~MappedMatchFile();
+    MappedMatchFile(const MappedMatchFile&) = delete;
+    MappedMatchFile& operator=(const MappedMatchFile&) = delete;
+
+    bool open(const std::string& path, std::string* error = nullptr);
+
+    // Valid while this object is alive and open
+    const std::optional<MatchView>& view() const { return view_; }
+
+private:
+    void close();
+
+    const void* mapping_ = nullptr;
+    size_t size_ = 0;
+    std::string buffer_;  // Fallback storage when the file isn't mmap'd
+    std::optional<MatchView> view_;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+/**
+ * On-disk cache of finished match payloads, keyed by match ID.
+ * A finished match never changes, so the raw /v2/matches/{id} body is stored
+ * gzip-compressed (one file per match) and reused across restarts and
+ * backfills. Total size is capped; least recently used files are evicted
+ * first (file mtimes carry recency across restarts).
+ */
+class MatchCache {
+public:
+    MatchCache(const std::string& directory, size_t max_bytes);
+
+    // Scan the cache directory (call once at startup)
+    void load();
+
+    // Raw JSON body for a match, if cached (unreadable files are dropped)
+    std::optional<std::string> get(const std::string& match_id);
+
+    // Store a match's raw JSON body (replacing any cached copy)
+    void put(const std::string& match_id, const std::string& body);
+
+    // Drop a cached match (e.g. its body no longer parses)
+    void evict(const std::string& match_id);
+
+    size_t hits() const;
+    size_t misses() const;
+
+    // Print size / hit-rate summary
+    void log_summary() const;
+
+private:
+    struct Entry {
+        size_t bytes = 0;
+        std::list<std::string>::iterator lru_pos;
+    };
+
+    std::filesystem::path path_for(const std::string& match_id) const;
+    static bool is_safe_id(const std::string& match_id);
+    void touch(const std::string& match_id, Entry& entry);
+    void remove_locked(const std::string& match_id);
+    void evict_if_needed();
+
+    std::filesystem::path directory_;
+    size_t max_bytes_;
+    size_t total_bytes_ = 0;
+
+    mutable std::mutex mutex_;
+    std::list<std::string> lru_;  // Front = most recently used
+    std::unordered_map<std::string, Entry> entries_;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+};
@@ -1,42 +1,44 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
 #include <string>
 #include <vector>
 #include <optional>
-
-struct PlayerStats {
-    std::string steam_id;
-    std::string name;
-    int kills = 0;
-    int deaths = 0;
-    int assists = 0;
-    double kd_ratio = 0.0;
-    int headshot_percentage = 0;
-    int adr = 0;  
-    bool won_match = false;
-    int team_number = -1;
-};
+#include "extended_stats.h"
+#include "roster.h"
+#include "steam_id.h"
+#include "tracked_index.h"
 
 struct TeamScore {
     int team_number = -1;
     int score = 0;
 };
 
+// Views into a match's roster; valid as long as the match is alive
+using PlayerViews = std::pmr::vector<PlayerRef>;
+
 struct MatchData {
     std::string match_id;
     std::string map_name;
     std::string game_finished_at;
-    std::vector<PlayerStats> players;
+    Roster players;
     std::vector<TeamScore> team_scores;
+    // Every other stats[] value, by roster index (empty unless parsed with
+    // parse_match_details_extended)
+    ExtendedStats extended;
     
-    // Get stats for a specific Steam ID
-    std::optional<PlayerStats> get_player_stats(const std::string& steam_id) const;
+    // Get stats for a specific Steam ID (nullopt if not in the match)
+    std::optional<PlayerRef> get_player_stats(SteamId steam_id) const;
     
     // Check if any tracked players are in this match
-    bool has_tracked_players(const std::vector<std::string>& tracked_ids) const;
+    bool has_tracked_players(const TrackedIndex& tracked) const;
     
-    // Get all tracked players' stats
-    std::vector<PlayerStats> get_tracked_players(const std::vector<std::string>& tracked_ids) const;
+    // Get all tracked players' stats (views, no copies)
+    PlayerViews get_tracked_players(const TrackedIndex& tracked,
+                                    std::pmr::memory_resource* memory = std::pmr::get_default_resource()) const;
     
     // Get final score as string (e.g., "13-10")
     std::string get_score_string() const;
@@ -45,6 +47,43 @@ struct MatchData {
     bool is_valid() const;
 };
 
+// A parsed match is never modified again; the pipeline (poller -> AI ->
+// Discord) shares one immutable copy instead of copying the roster around
+using MatchSnapshot = std::shared_ptr<const MatchData>;
+
+// One entry of a player's /v3/profile/matches list (newest first)
+struct MatchListEntry {
+    std::string id;
+    std::string finished_at;
+};
+
 // Parse JSON response from Leetify API
+// Match details are streamed (SAX) straight into MatchData without building a DOM
 MatchData parse_match_details_from_json(const std::string& body, const std::string& match_id);
+// DOM-based reference implementation of the above (same output, slower)
+MatchData parse_match_details_from_json_dom(const std::string& body, const std::string& match_id);
+// Hand-written parser specialised to the /v2/matches layout, for bulk
+// imports (SIMD string scanning, no tokenizer in between). Returns nullopt
+// whenever the payload isn't a plain, well-formed document of the expected
+// shape; use parse_match_details_from_json then. When it does return, the
+// result matches parse_match_details_from_json's.
+std::optional<MatchData> parse_match_details_fast(const std::string& body, const std::string& match_id);
+// The fast path above, also recording the byte range of every stats[] value
+// it doesn't read into MatchData::extended (same single pass). The match
+// shares `body` for decoding them later.
+std::optional<MatchData> parse_match_details_extended(std::shared_ptr<const std::string> body,
+                                                      const std::string& match_id);
 std::string parse_most_recent_match_id(const std::string& body);
+
+// Decides when a streamed match list can stop: return true to stop right
+// after this entry (it is still included in the result)
+using MatchListStop = std::function<bool(const MatchListEntry&)>;
+
+// Parse a /v3/profile/matches list (newest first). With `stop_after`, the
+// rest of the list is never scanned once it returns true.
+std::vector<MatchListEntry> parse_match_list(const std::string& body,
+                                             const MatchListStop& stop_after = nullptr);
+
+// Parse a Leetify ISO-8601 UTC timestamp (e.g. "2024-05-12T19:02:33.000Z")
+// into seconds since the Unix epoch
+std::optional<int64_t> parse_timestamp_utc(const std::string& timestamp);
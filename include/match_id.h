@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/**
+ * A Leetify match ID as a 128-bit value. Leetify IDs are UUIDs
+ * ("xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx"), which parse losslessly; anything
+ * else is mapped to a stable 128-bit hash so it can still be stored and
+ * compared the same way (to_string() is only meaningful for UUIDs).
+ */
+class MatchId {
+public:
+    static constexpr size_t kBytes = 16;
+
+    constexpr MatchId() = default;
+    constexpr MatchId(uint64_t hi, uint64_t lo) : hi_(hi), lo_(lo) {}
+
+    // Parse a canonical UUID (hex digits in either case)
+    static std::optional<MatchId> parse_uuid(std::string_view text) {
+        if (text.size() != 36) return std::nullopt;
+
+        uint64_t halves[2] = {0, 0};
+        int digits = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            char c = text[i];
+            if (i == 8 || i == 13 || i == 18 || i == 23) {
+                if (c != '-') return std::nullopt;
+                continue;
+            }
+            int nibble = hex_value(c);
+            if (nibble < 0) return std::nullopt;
+            uint64_t& half = halves[digits / 16];
+            half = (half << 4) | static_cast<uint64_t>(nibble);
+            ++digits;
+        }
+        return MatchId(halves[0], halves[1]);
+    }
+
+    // UUIDs parse exactly; other IDs get a stable hash (same on every run)
+    static MatchId from_string(std::string_view text) {
+        if (auto uuid = parse_uuid(text)) return *uuid;
+
+        // Two independent FNV-1a passes (forward and backward)
+        uint64_t hi = 14695981039346656037ULL;
+        uint64_t lo = 0x6c62272e07bb0142ULL;
+        for (size_t i = 0; i < text.size(); ++i) {
+            hi = (hi ^ static_cast<unsigned char>(text[i])) * 1099511628211ULL;
+            lo = (lo ^ static_cast<unsigned char>(text[text.size() - 1 - i])) * 1099511628211ULL;
+        }
+        return MatchId(hi, lo);
+    }
+
+    // Canonical lowercase UUID form
+    std::string to_string() const {
+        static const char kHex[] = "0123456789abcdef";
+        std::string out(36, '-');
+        size_t pos = 0;
+        for (int digit = 0; digit < 32; ++digit) {
+            if (pos == 8 || pos == 13 || pos == 18 || pos == 23) ++pos;
+            uint64_t half = digit < 16 ? hi_ : lo_;
+            int shift = 60 - 4 * (digit % 16);
+            out[pos++] = kHex[(half >> shift) & 0xF];
+        }
+        return out;
+    }
+
+    // Big-endian 16-byte form (same byte order as the UUID text)
+    void to_bytes(unsigned char* out) const {
+        for (int i = 0; i < 8; ++i) {
+            out[i] = static_cast<unsigned char>(hi_ >> (56 - 8 * i));
+            out[8 + i] = static_cast<unsigned char>(lo_ >> (56 - 8 * i));
+        }
+    }
+
+    static MatchId from_bytes(const unsigned char* in) {
+        uint64_t hi = 0, lo = 0;
+        for (int i = 0; i < 8; ++i) {
+            hi = (hi << 8) | in[i];
+            lo = (lo << 8) | in[8 + i];
+        }
+        return MatchId(hi, lo);
+    }
+
+    constexpr uint64_t hi() const { return hi_; }
+    constexpr uint64_t lo() const { return lo_; }
+
+    constexpr bool operator==(const MatchId& other) const { return hi_ == other.hi_ && lo_ == other.lo_; }
+    constexpr bool operator!=(const MatchId& other) const { return !(*this == other); }
+    constexpr bool operator<(const MatchId& other) const {
+        return hi_ != other.hi_ ? hi_ < other.hi_ : lo_ < other.lo_;
+    }
+
+private:
+    static constexpr int hex_value(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    uint64_t hi_ = 0;
+    uint64_t lo_ = 0;
+};
+
+namespace std {
+template <>
+struct hash<MatchId> {
+    size_t operator()(const MatchId& id) const noexcept {
+        // UUID bits are already random; fold the halves together
+        return static_cast<size_t>(id.hi() ^ (id.lo() * 0x9e3779b97f4a7c15ULL));
+    }
+};
+}  // namespace std
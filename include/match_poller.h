@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "leetify_client.h"
+#include "match_data.h"
+#include "persistence.h"
+#include "player_cursors.h"
+#include "task_pool.h"
+
+// Summary of one polling cycle
+struct PollCycleStats {
+    size_t players_polled = 0;
+    size_t new_matches = 0;
+    size_t coalesced_fetches = 0;
+    size_t detail_requests = 0;  // Detail fetches that went to Leetify (not cached or coalesced)
+    size_t polls_saved = 0;  // List polls skipped because a co-player's match resolved them
+    size_t unchanged_lists = 0;  // List responses identical to the previous poll (not parsed)
+    double wall_seconds = 0.0;
+};
+
+// Which entries of a player's match list to fetch (see plan_catchup)
+struct CatchupPlan {
+    std::vector<std::string> unseen;  // To fetch and post, oldest first
+    std::vector<std::string> retire;  // Older history to mark seen without posting
+    size_t left_for_later = 0;        // Unseen matches beyond the catch-up limit
+};
+
+/**
+ * Pick the matches to fetch from a player's match list (newest first).
+ *
+ * With a cursor, the walk collects unseen matches until the first seen match
+ * at or below the cursor (same match ID, or finished no later). Seen matches
+ * above the cursor don't stop it: a co-player's list may already have posted
+ * the newest one while older unseen matches remain. At most `limit` matches
+ * are returned, the oldest ones; the newer rest stay unseen and the next walk
+ * picks them up.
+ *
+ * Without a cursor (newly tracked player) only the newest match is fetched
+ * and the rest of the list is retired, so their history isn't posted.
+ */
+CatchupPlan plan_catchup(const std::vector<MatchListEntry>& entries,
+                         const std::optional<PlayerCursor>& cursor,
+                         const std::function<bool(const std::string&)>& is_seen,
+                         size_t limit);
+
+/**
+ * Polls tracked players' recent matches in parallel on a bounded worker pool
+ * and collects every unseen match, deduplicated by match ID. Each player's
+ * match list is walked down to their saved cursor (plan_catchup), so games
+ * played between polls (or while the tracker was offline) are caught up as
+ * well. Tracked players found in a freshly parsed match are resolved for the
+ * rest of the cycle and not polled again. Every successful list read updates
+ * the player's persisted cursor, unless one of their detail fetches failed.
+ */
+class MatchPoller {
+public:
+    // Called from worker threads with each player's freshly fetched match list
+    using ListObserver = std::function<void(SteamId steam_id,
+                                            const std::vector<MatchListEntry>& entries)>;
+
+    MatchPoller(LeetifyClient& leetify, PersistenceManager& persistence,
+                PlayerCursorStore& cursors, int concurrency, int catchup_max_matches);
+
+    // Poll all given Steam IDs; returns new (unseen) matches, oldest first
+    std::vector<MatchSnapshot> poll(const std::vector<SteamId>& steam_ids,
+                                    const std::atomic<bool>& running);
+
+    // Stats from the most recent call to poll()
+    const PollCycleStats& last_cycle_stats() const { return last_stats_; }
+
+    // List polls skipped via co-play suppression since startup
+    size_t total_polls_saved() const { return total_polls_saved_; }
+
+    // Players with a failed detail fetch in the most recent call to poll()
+    const std::unordered_set<SteamId>& last_failed_players() const { return last_failed_ids_; }
+
+    // Register a callback for fetched match lists (must be thread-safe)
+    void set_list_observer(ListObserver observer) { list_observer_ = std::move(observer); }
+
+private:
+    // Per-cycle state shared between workers
+    struct CycleState {
+        std::mutex mutex;
+        std::unordered_map<MatchId, MatchSnapshot> new_matches;
+        std::unordered_set<SteamId> tracked_ids;
+        // Players whose newest match is already known this cycle
+        std::unordered_set<SteamId> resolved_ids;
+        size_t polls_saved = 0;
+        int64_t started_at = 0;
+        // History of newly tracked players, marked seen once the workers are done
+        std::vector<std::string> retired_ids;
+        // New cursors, saved once the workers are done unless one of the
+        // player's detail fetches failed (the next walk must reach that match)
+        std::unordered_map<SteamId, PlayerCursor> pending_cursors;
+        std::unordered_set<SteamId> failed_ids;
+    };
+
+    // Returns false if the player was skipped (already resolved by a co-player)
+    bool poll_player(SteamId steam_id, CycleState& cycle);
+
+    // Fetch details for one unseen match and add it to the cycle's results
+    void collect_match(SteamId steam_id, const std::string& match_id, CycleState& cycle);
+
+    // Mark tracked participants as resolved for this cycle if the match
+    // finished after their last poll, so it is at least as new as anything
+    // their list held then. Skipping their list read this cycle loses
+    // nothing: older unseen matches are still above their cursor, and the
+    // next walk doesn't stop at the seen match.
+    void mark_participants_resolved(const MatchData& match, CycleState& cycle);
+
+    LeetifyClient& leetify_;
+    PersistenceManager& persistence_;
+    PlayerCursorStore& cursors_;
+    TaskPool pool_;
+    size_t catchup_max_matches_;
+    PollCycleStats last_stats_;
+    size_t total_polls_saved_ = 0;
+    std::unordered_set<SteamId> last_failed_ids_;
+    ListObserver list_observer_;
+
+    // steam_id -> unix time of the player's last completed list poll
+    // (seeded from the cursor store; only touched under the current cycle's mutex)
+    std::unordered_map<SteamId, int64_t> last_polled_at_;
+
+    // Players whose full match list has been read once since startup
+    // (only touched under the current cycle's mutex)
+    std::unordered_set<SteamId> history_read_;
+};
@@ -1,73 +1,130 @@
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include <unordered_set>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <filesystem>
+#include <vector>
+#include "match_id.h"
 
 /**
  * Manages persistence of seen match IDs to avoid re-reporting matches after restart.
- * Stores data in a simple text file, one match ID per line.
+ * IDs are kept as 128-bit MatchIds and stored in a binary file: an 8-byte
+ * header followed by one 16-byte record per match. Newly seen matches are
+ * appended; save() rewrites the whole file. A legacy text file (one match ID
+ * per line) is migrated on first load.
  */
 class PersistenceManager {
 public:
-    explicit PersistenceManager(const std::string& filepath = "seen_matches.txt")
-        : filepath_(filepath) {}
-    
+    explicit PersistenceManager(const std::string& filepath = "seen_matches.bin",
+                                const std::string& legacy_text_path = "seen_matches.txt")
+        : filepath_(filepath), legacy_text_path_(legacy_text_path) {}
+
     // Load seen matches from file
     bool load() {
         seen_match_ids_.clear();
-        
-        std::ifstream file(filepath_);
+
+        std::ifstream file(filepath_, std::ios::binary);
         if (!file.is_open()) {
+            if (migrate_legacy_text()) return true;
             // File doesn't exist yet - that's OK for first run
             std::cout << "[persistence] No existing file found, starting fresh\n";
             return true;
         }
-        
-        std::string line;
-        while (std::getline(file, line)) {
-            if (!line.empty()) {
-                seen_match_ids_.insert(line);
-            }
+
+        std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)),
+                                        std::istreambuf_iterator<char>());
+        if (data.size() < kMagicSize ||
+            !std::equal(kMagic, kMagic + kMagicSize, data.begin())) {
+            std::cerr << "[persistence] " << filepath_ << " is not a seen-matches file, moving it aside\n";
+            file.close();
+            std::error_code ec;
+            std::filesystem::rename(filepath_, filepath_ + ".corrupt", ec);
+            return false;
         }
-        
+
+        // A partially written trailing record (crash mid-append) is ignored
+        size_t records = (data.size() - kMagicSize) / MatchId::kBytes;
+        seen_match_ids_.reserve(records);
+        for (size_t i = 0; i < records; ++i) {
+            seen_match_ids_.insert(MatchId::from_bytes(&data[kMagicSize + i * MatchId::kBytes]));
+        }
+        if ((data.size() - kMagicSize) % MatchId::kBytes != 0) {
+            file.close();
+            save();  // Drop the torn record so later appends stay aligned
+        }
+
         std::cout << "[persistence] Loaded " << seen_match_ids_.size() << " seen match IDs\n";
         return true;
     }
-    
-    // Save seen matches to file
+
+    // Save seen matches to file (written to a temp file and renamed into place)
     bool save() const {
-        std::ofstream file(filepath_);
-        if (!file.is_open()) {
-            std::cerr << "[persistence] Failed to open file for writing: " << filepath_ << "\n";
-            return false;
+        std::string tmp_path = filepath_ + ".tmp";
+        {
+            std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                std::cerr << "[persistence] Failed to open file for writing: " << tmp_path << "\n";
+                return false;
+            }
+
+            std::vector<unsigned char> data(kMagic, kMagic + kMagicSize);
+            data.resize(kMagicSize + seen_match_ids_.size() * MatchId::kBytes);
+            size_t offset = kMagicSize;
+            for (const auto& match_id : seen_match_ids_) {
+                match_id.to_bytes(&data[offset]);
+                offset += MatchId::kBytes;
+            }
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            if (!file.good()) return false;
         }
-        
-        for (const auto& match_id : seen_match_ids_) {
-            file << match_id << "\n";
+
+        std::error_code ec;
+        std::filesystem::rename(tmp_path, filepath_, ec);
+        if (ec) {
+            std::cerr << "[persistence] Failed to save " << filepath_ << ": " << ec.message() << "\n";
+            return false;
         }
-        
-        return file.good();
+        return true;
     }
-    
+
     // Check if a match has been seen
-    bool has_seen(const std::string& match_id) const {
+    bool has_seen(const MatchId& match_id) const {
         return seen_match_ids_.count(match_id) > 0;
     }
-    
+
+    bool has_seen(const std::string& match_id) const {
+        return has_seen(MatchId::from_string(match_id));
+    }
+
     // Mark a match as seen (does NOT auto-save)
     void mark_seen(const std::string& match_id) {
-        seen_match_ids_.insert(match_id);
+        seen_match_ids_.insert(MatchId::from_string(match_id));
     }
-    
-    // Mark a match as seen and immediately persist
+
+    // Mark a match as seen and immediately persist (appends one record)
     bool mark_seen_and_save(const std::string& match_id) {
-        mark_seen(match_id);
-        return save();
+        MatchId id = MatchId::from_string(match_id);
+        if (!seen_match_ids_.insert(id).second) return true;
+
+        bool is_new_file = !std::filesystem::exists(filepath_);
+        std::ofstream file(filepath_, std::ios::binary | std::ios::app);
+        if (!file.is_open()) {
+            std::cerr << "[persistence] Failed to open file for writing: " << filepath_ << "\n";
+            return false;
+        }
+        if (is_new_file) {
+            file.write(reinterpret_cast<const char*>(kMagic), kMagicSize);
+        }
+        unsigned char record[MatchId::kBytes];
+        id.to_bytes(record);
+        file.write(reinterpret_cast<const char*>(record), MatchId::kBytes);
+        return file.good();
     }
-    
+
     // Get count of seen matches
     size_t size() const { return seen_match_ids_.size(); }
 
@@ -76,14 +133,41 @@ public:
 
     // Clear all seen matches
     void clear() { seen_match_ids_.clear(); }
-    
+
     // Get the most recently added match ID (for display purposes)
     std::string get_last_match_id() const {
         return last_added_;
     }
 
 private:
+    static constexpr size_t kMagicSize = 8;
+    static constexpr unsigned char kMagic[kMagicSize] = {'C', 'S', 'H', 'S', 'E', 'E', 'N', '1'};
+
+    // Import the old one-ID-per-line text file, then keep it as a backup
+    bool migrate_legacy_text() {
+        if (legacy_text_path_.empty()) return false;
+
+        std::ifstream legacy(legacy_text_path_);
+        if (!legacy.is_open()) return false;
+
+        std::string line;
+        while (std::getline(legacy, line)) {
+            if (!line.empty()) {
+                seen_match_ids_.insert(MatchId::from_string(line));
+            }
+        }
+        legacy.close();
+
+        if (!save()) return false;
+        std::error_code ec;
+        std::filesystem::rename(legacy_text_path_, legacy_text_path_ + ".migrated", ec);
+        std::cout << "[persistence] Migrated " << seen_match_ids_.size() << " seen match IDs from "
+                  << legacy_text_path_ << " to " << filepath_ << "\n";
+        return true;
+    }
+
     std::string filepath_;
-    std::unordered_set<std::string> seen_match_ids_;
+    std::string legacy_text_path_;
+    std::unordered_set<MatchId> seen_match_ids_;
     std::string last_added_;
 };
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include "steam_id.h"
+
+// Newest match seen in a player's match list, and when the list was last read.
+// match_id / finished_at mark where the next catch-up walk stops
+// (plan_catchup); polled_at resumes the player's poll schedule.
+struct PlayerCursor {
+    std::string match_id;
+    std::string finished_at;  // Leetify timestamp of match_id (may be empty)
+    int64_t polled_at = 0;    // Unix time of the last successful list poll
+};
+
+/**
+ * Persists each tracked player's latest-match cursor so a restart can resume
+ * polling where it left off instead of re-reading everyone's match list, and
+ * catch up on exactly the matches played since.
+ * Stored as a tab-separated text file, one player per line:
+ *   steam_id  match_id  finished_at  polled_at
+ * Updated from poll worker threads; saved once per poll cycle.
+ */
+class PlayerCursorStore {
+public:
+    explicit PlayerCursorStore(const std::string& filepath = "player_cursors.txt")
+        : filepath_(filepath) {}
+
+    // Load cursors from file
+    bool load() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cursors_.clear();
+
+        std::ifstream file(filepath_);
+        if (!file.is_open()) {
+            std::cout << "[cursors] No existing file found, starting fresh\n";
+            return true;
+        }
+
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream fields(line);
+            std::string steam_id, polled_at;
+            PlayerCursor cursor;
+            if (!std::getline(fields, steam_id, '\t') || !std::getline(fields, cursor.match_id, '\t') ||
+                !std::getline(fields, cursor.finished_at, '\t') || !std::getline(fields, polled_at)) {
+                continue;
+            }
+            try {
+                cursor.polled_at = std::stoll(polled_at);
+            } catch (...) {
+                continue;
+            }
+            auto id = SteamId::parse(steam_id);
+            if (id && !cursor.match_id.empty()) {
+                cursors_[*id] = std::move(cursor);
+            }
+        }
+
+        std::cout << "[cursors] Loaded " << cursors_.size() << " player cursor(s)\n";
+        return true;
+    }
+
+    // Save cursors to file (written to a temp file and renamed into place)
+    bool save() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::string tmp_path = filepath_ + ".tmp";
+        {
+            std::ofstream file(tmp_path, std::ios::trunc);
+            if (!file.is_open()) {
+                std::cerr << "[cursors] Failed to open file for writing: " << tmp_path << "\n";
+                return false;
+            }
+            for (const auto& [steam_id, cursor] : cursors_) {
+                file << steam_id << '\t' << cursor.match_id << '\t' << cursor.finished_at << '\t'
+                     << cursor.polled_at << "\n";
+            }
+            if (!file.good()) return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmp_path, filepath_, ec);
+        if (ec) {
+            std::cerr << "[cursors] Failed to save " << filepath_ << ": " << ec.message() << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    std::optional<PlayerCursor> get(SteamId steam_id) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = cursors_.find(steam_id);
+        if (it == cursors_.end()) return std::nullopt;
+        return it->second;
+    }
+
+    // Record a fresh list read with `match_id` as the player's newest match
+    void update(SteamId steam_id, const std::string& match_id,
+                const std::string& finished_at, int64_t polled_at) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        PlayerCursor& cursor = cursors_[steam_id];
+        cursor.match_id = match_id;
+        cursor.finished_at = finished_at;
+        cursor.polled_at = polled_at;
+    }
+
+    // Record a list read that found nothing new (keeps the existing cursor)
+    void touch(SteamId steam_id, int64_t polled_at) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = cursors_.find(steam_id);
+        if (it != cursors_.end()) {
+            it->second.polled_at = polled_at;
+        }
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cursors_.size();
+    }
+
+private:
+    std::string filepath_;
+    mutable std::mutex mutex_;
+    std::unordered_map<SteamId, PlayerCursor> cursors_;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+
+// How a stat is printed in prompts and reports
+enum class StatFormat { Integer, Percent, Fixed2 };
+
+/**
+ * Per-player stats, one line each. PlayerStats members, Roster columns and
+ * PlayerRef accessors, stats[] extraction in both JSON parsers, the stat
+ * columns of the binary match format (match_binary.h) and prompt/report
+ * formatting are all generated from this table, so adding a stat is a
+ * single line here.
+ *
+ * X(member, type, default, json_key, label, format)
+ *   json_key  key in a /v2/matches stats[] entry; "" for stats that are
+ *             derived once the entry is complete (derive_player_stats)
+ *   label     name in prompts and reports; "" keeps it out of them.
+ *             Neighbouring stats with the same label print together
+ *             ("K/D/A 21/14/3")
+ * Stats print in table order.
+ */
+#define PLAYER_STAT_FIELDS(X)                                                          \
+    X(kills,               int32_t, 0,     "total_kills",         "K/D/A", StatFormat::Integer) \
+    X(deaths,              int32_t, 0,     "total_deaths",        "K/D/A", StatFormat::Integer) \
+    X(assists,             int32_t, 0,     "total_assists",       "K/D/A", StatFormat::Integer) \
+    X(adr,                 int32_t, 0,     "",                    "ADR",   StatFormat::Integer) \
+    X(headshot_percentage, int32_t, 0,     "",                    "HS%",   StatFormat::Percent) \
+    X(kd_ratio,            double,  0.0,   "kd_ratio",            "KD",    StatFormat::Fixed2)  \
+    X(team_number,         int32_t, -1,    "initial_team_number", "",      StatFormat::Integer) \
+    X(won_match,           bool,    false, "",                    "",      StatFormat::Integer)
+
+/**
+ * Raw stats[] values that are only read to derive a stat above (not stored).
+ * X(member, type, default, json_key)
+ */
+#define PLAYER_INPUT_FIELDS(X)                 \
+    X(dpr,            double,  0.0, "dpr")     \
+    X(total_hs_kills, int32_t, 0,   "total_hs_kills")
+
+/**
+ * Optional stats[] values added to tracked players' prompt lines when
+ * extended stats are on. They aren't parsed into the roster; each is decoded
+ * from MatchData::extended only when a prompt is built, and skipped if the
+ * payload doesn't have it.
+ * X(json_key, label, format)
+ */
+#define PLAYER_EXTENDED_FIELDS(X)                                         \
+    X("mvps",                "MVPs",            StatFormat::Integer)      \
+    X("multi3k",             "3Ks",             StatFormat::Integer)      \
+    X("multi4k",             "4Ks",             StatFormat::Integer)      \
+    X("multi5k",             "Aces",            StatFormat::Integer)      \
+    X("trade_kills_succeed", "Trade kills",     StatFormat::Integer)      \
+    X("flashbang_hit_foe",   "Enemies flashed", StatFormat::Integer)      \
+    X("he_foes_damage_avg",  "HE dmg/nade",     StatFormat::Fixed2)
+
+enum class PlayerStat : uint32_t {
+#define X(member, ...) member,
+    PLAYER_STAT_FIELDS(X)
+#undef X
+    Count
+};
+
+// Set of stats to print, one bit per PlayerStat
+using StatMask = uint32_t;
+
+constexpr StatMask stat_bit(PlayerStat stat) { return StatMask(1) << static_cast<uint32_t>(stat); }
+
+constexpr StatMask kKdaStats =
+    stat_bit(PlayerStat::kills) | stat_bit(PlayerStat::deaths) | stat_bit(PlayerStat::assists);
+
+// Every stat that has a label
+constexpr StatMask kAllShownStats = 0
+#define X(member, type, def, key, label, format) | (label[0] != '\0' ? stat_bit(PlayerStat::member) : 0)
+    PLAYER_STAT_FIELDS(X)
+#undef X
+    ;
+
+// Separators used when printing stats
+struct StatStyle {
+    const char* label_separator;  // Between a label and its value(s)
+    const char* separator;        // Between stats
+};
+
+constexpr StatStyle kInlineStats{" ", ", "};  // K/D/A 21/14/3, ADR 88
+constexpr StatStyle kLogStats{": ", " | "};   // K/D/A: 21/14/3 | ADR: 88
+constexpr StatStyle kListStats{": ", "\n"};   // One stat per line
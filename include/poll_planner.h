@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "match_data.h"
+
+/**
+ * Rations list polls against a fixed Leetify requests-per-minute budget.
+ *
+ * Each player keeps an hour-of-week histogram of when their matches finish
+ * (built from game_finished_at / finished_at). The expected value of polling a
+ * player is the probability they finished at least one match since their last
+ * poll, integrated over that histogram. When the budget can't cover every due
+ * player, the highest-value ones go first and the rest are deferred.
+ *
+ * Also tracks predicted (half the gap between polls) versus actual
+ * (detection time - game_finished_at) detection lag.
+ */
+class PollPlanner {
+public:
+    // requests_per_minute <= 0 disables rationing (every due player is polled)
+    explicit PollPlanner(int requests_per_minute);
+
+    // Split due players into the ones to poll now (returned, best first) and
+    // the ones to defer. Records a poll for every returned player.
+    std::vector<SteamId> plan(const std::vector<SteamId>& due_ids,
+                                  std::vector<SteamId>& deferred_ids);
+
+    // Charge extra requests against the budget (e.g. detail fetches)
+    void charge(size_t requests);
+
+    // Give back planned polls that never reached the network (e.g. skipped
+    // because a co-player's match already resolved the player)
+    void refund(size_t requests);
+
+    // Feed a player's match list into their play-time histogram (thread-safe)
+    void observe_matches(SteamId steam_id, const std::vector<MatchListEntry>& entries);
+
+    // Record that a match finishing at `game_finished_at` was detected now
+    void record_detection(SteamId steam_id, const std::string& game_finished_at);
+
+    // Suggested delay before deferred players are retried
+    int retry_delay_seconds() const;
+
+    // Print budget and detection lag summary
+    void log_summary() const;
+
+private:
+    static constexpr int kHoursPerWeek = 168;
+
+    struct PlayerHistory {
+        std::array<uint32_t, kHoursPerWeek> finished_by_hour{};
+        uint32_t total_matches = 0;
+        int64_t oldest_finished_at = 0;
+        int64_t newest_finished_at = 0;
+        int64_t last_poll_at = 0;
+        int64_t previous_poll_at = 0;
+    };
+
+    void refill(int64_t now_unix);
+    double expected_matches(const PlayerHistory& history, int64_t from_unix, int64_t to_unix) const;
+
+    // Probability (0..1) that polling now finds at least one new match
+    double poll_value(const PlayerHistory& history, int64_t now_unix) const;
+
+    double requests_per_minute_;
+    double credit_;
+    int64_t last_refill_at_ = 0;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<SteamId, PlayerHistory> players_;
+
+    // Detection lag accounting (seconds)
+    size_t detections_ = 0;
+    double predicted_lag_total_ = 0.0;
+    double actual_lag_total_ = 0.0;
+    size_t polls_planned_ = 0;
+    size_t polls_deferred_ = 0;
+};
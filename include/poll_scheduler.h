@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "steam_id.h"
+
+// What a player's poll turned up
+enum class PollOutcome {
+    NewMatch,     // Poll again soon (people tend to re-queue)
+    NothingNew,   // Back off
+    FetchFailed,  // A detail fetch failed; retry soon without growing the backoff
+};
+
+/**
+ * Per-player poll timer. Players who just finished a match are polled again
+ * soon (people tend to re-queue within minutes); idle players back off
+ * exponentially up to a ceiling. Due times live in a min-heap, so a tick
+ * costs O(k log n) for k due players instead of a scan over everyone.
+ */
+class PollScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    PollScheduler(int base_interval_seconds, int active_interval_seconds, int max_interval_seconds);
+
+    // Register a player; their first poll is due at `first_due`
+    void add_player(SteamId steam_id, Clock::time_point first_due);
+
+    // Remove and return every player whose poll is due at `now`. Each returned
+    // player must be handed back through record_poll().
+    std::vector<SteamId> pop_due(Clock::time_point now);
+
+    // Reschedule a player after a poll. Players with a new match drop to the
+    // active interval; players with nothing new double their interval up to
+    // the max; failed fetches are retried after the active interval with the
+    // player's interval left as it was. Can also be called for players that
+    // were not due (e.g. they showed up in someone else's new match) to pull
+    // their next poll forward.
+    void record_poll(SteamId steam_id, PollOutcome outcome, Clock::time_point now);
+
+    // Put a popped player back without changing their interval (e.g. deferred
+    // by the request budget)
+    void postpone(SteamId steam_id, Clock::time_point due);
+
+    // Earliest pending due time, if any player is scheduled
+    std::optional<Clock::time_point> next_due();
+
+    // Current interval for a player (0 if unknown)
+    std::chrono::seconds interval_for(SteamId steam_id) const;
+
+    size_t size() const { return players_.size(); }
+
+private:
+    struct PlayerState {
+        std::chrono::seconds interval{0};
+        uint64_t generation = 0;  // Bumped on every reschedule; older heap entries are stale
+    };
+
+    struct HeapEntry {
+        Clock::time_point due;
+        uint64_t generation;
+        SteamId steam_id;
+
+        bool operator>(const HeapEntry& other) const { return due > other.due; }
+    };
+
+    void schedule(SteamId steam_id, PlayerState& state, Clock::time_point due);
+    void drop_stale_entries();
+
+    std::chrono::seconds base_interval_;
+    std::chrono::seconds active_interval_;
+    std::chrono::seconds max_interval_;
+
+    std::unordered_map<SteamId, PlayerState> players_;
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap_;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+/**
+ * Token-bucket limiter shared by every request to one upstream API.
+ * acquire() queues the caller until a token is available instead of failing,
+ * and the bucket can be paused when the server answers 429 / reports an
+ * exhausted quota. Time spent waiting is accumulated as a metric.
+ */
+class RateLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // requests_per_minute <= 0 means no client-side limit (server pauses still apply)
+    RateLimiter(int requests_per_minute, int burst);
+
+    // Block until a request may be sent
+    void acquire();
+
+    // Hold back all requests for `delay` (e.g. from a Retry-After header)
+    void pause_for(std::chrono::milliseconds delay);
+
+    // Feed quota headers: `remaining` requests left until `reset_in` elapses
+    void observe_quota(long remaining, std::chrono::seconds reset_in);
+
+    // Count a 429 response
+    void record_throttled();
+
+    double total_wait_seconds() const;
+    size_t throttled_count() const;
+
+    // Print wait-time / throttling summary
+    void log_summary() const;
+
+private:
+    void refill(Clock::time_point now);
+
+    double tokens_per_second_;
+    double capacity_;
+    double tokens_;
+    Clock::time_point last_refill_;
+    Clock::time_point paused_until_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+
+    std::chrono::nanoseconds total_wait_{0};
+    size_t waits_ = 0;
+    size_t throttled_ = 0;
+};
@@ -0,0 +1,343 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "player_fields.h"
+#include "steam_id.h"
+
+struct PlayerStats {
+    SteamId steam_id;
+    std::string name;
+#define X(member, type, def, ...) type member = def;
+    PLAYER_STAT_FIELDS(X)
+#undef X
+};
+
+/**
+ * Process-wide pool of player names. The same handful of friends (and their
+ * usual opponents) show up in match after match, so each roster only keeps a
+ * pointer to the shared copy. Entries are reference counted by the rosters
+ * holding them and dropped with the last one, so the table only ever holds
+ * the names of matches still in memory. The price is a global lock per
+ * interned player and one per roster copy or destruction.
+ */
+class NameTable {
+public:
+    static NameTable& global() {
+        static NameTable table;
+        return table;
+    }
+
+    // Shared copy of `name`, referenced once more; hand it back with release()
+    const std::string* intern(const std::string& name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = names_.try_emplace(name, 0).first;
+        ++it->second;
+        return &it->first;
+    }
+
+    // Reference / drop interned names (e.g. a whole roster column)
+    void acquire(const std::string* const* names, size_t count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < count; ++i) ++names_.find(*names[i])->second;
+    }
+
+    void release(const std::string* const* names, size_t count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < count; ++i) {
+            auto it = names_.find(*names[i]);
+            if (--it->second == 0) names_.erase(it);
+        }
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return names_.size();
+    }
+
+private:
+    NameTable() = default;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, size_t> names_;  // name -> rosters' references; node keys don't move
+};
+
+// Column element type for a stat (bools are stored as bytes)
+template <typename T> struct ColumnOf { using type = T; };
+template <> struct ColumnOf<bool> { using type = uint8_t; };
+template <typename T> using column_t = typename ColumnOf<T>::type;
+
+/**
+ * Contiguous column with room for N elements inline; only spills to the heap
+ * when a roster grows past N. For trivially copyable T.
+ */
+template <typename T, size_t N>
+class InlineColumn {
+public:
+    InlineColumn() = default;
+    InlineColumn(const InlineColumn&) = default;
+    InlineColumn& operator=(const InlineColumn&) = default;
+
+    InlineColumn(InlineColumn&& other) noexcept
+        : inline_(other.inline_), heap_(std::move(other.heap_)), size_(other.size_) {
+        other.heap_.clear();
+        other.size_ = 0;
+    }
+
+    InlineColumn& operator=(InlineColumn&& other) noexcept {
+        inline_ = other.inline_;
+        heap_ = std::move(other.heap_);
+        size_ = other.size_;
+        other.heap_.clear();
+        other.size_ = 0;
+        return *this;
+    }
+
+    void push_back(T value) {
+        if (heap_.empty() && size_ < N) {
+            inline_[size_++] = value;
+            return;
+        }
+        if (heap_.empty()) {
+            heap_.assign(inline_.begin(), inline_.begin() + size_);
+        }
+        heap_.push_back(value);
+        ++size_;
+    }
+
+    void reserve(size_t capacity) {
+        if (capacity <= N) return;
+        if (heap_.empty()) heap_.assign(inline_.begin(), inline_.begin() + size_);
+        heap_.reserve(capacity);
+    }
+
+    void clear() {
+        heap_.clear();
+        size_ = 0;
+    }
+
+    // Once spilled, every element lives in heap_
+    const T* data() const { return heap_.empty() ? inline_.data() : heap_.data(); }
+    T* data() { return heap_.empty() ? inline_.data() : heap_.data(); }
+    size_t size() const { return size_; }
+
+    const T& operator[](size_t i) const { return data()[i]; }
+    T& operator[](size_t i) { return data()[i]; }
+
+private:
+    std::array<T, N> inline_{};
+    std::vector<T> heap_;
+    size_t size_ = 0;
+};
+
+class Roster;
+
+/**
+ * Read-only view of one player in a Roster, with the same fields as
+ * PlayerStats exposed as accessors. Cheap to copy; valid as long as the
+ * roster is alive and unmodified.
+ */
+class PlayerRef {
+public:
+    PlayerRef(const Roster& roster, size_t index) : roster_(&roster), index_(index) {}
+
+    SteamId steam_id() const;
+    const std::string& name() const;
+#define X(member, type, ...) type member() const;
+    PLAYER_STAT_FIELDS(X)
+#undef X
+
+    size_t index() const { return index_; }
+
+    // Materialize a standalone copy (for code that still wants PlayerStats)
+    PlayerStats to_stats() const;
+
+private:
+    const Roster* roster_;
+    size_t index_;
+};
+
+/**
+ * A match's players stored column by column (structure of arrays), one
+ * column per PLAYER_STAT_FIELDS entry. A normal 5v5 fits in the inline
+ * capacity, so a roster costs no heap allocations, and names are shared
+ * through NameTable. Aggregations over many matches read one tightly packed
+ * column per roster instead of striding over whole PlayerStats records.
+ */
+class Roster {
+public:
+    static constexpr size_t kInlinePlayers = 10;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = PlayerRef;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = PlayerRef;
+
+        const_iterator(const Roster& roster, size_t index) : roster_(&roster), index_(index) {}
+
+        PlayerRef operator*() const { return PlayerRef(*roster_, index_); }
+        const_iterator& operator++() { ++index_; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++index_; return old; }
+        bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const const_iterator& other) const { return index_ != other.index_; }
+
+    private:
+        const Roster* roster_;
+        size_t index_;
+    };
+
+    Roster() = default;
+
+    Roster(const Roster& other)
+        : steam_ids_(other.steam_ids_), names_(other.names_)
+#define X(member, ...) , member##_(other.member##_)
+          PLAYER_STAT_FIELDS(X)
+#undef X
+    {
+        NameTable::global().acquire(names_.data(), names_.size());
+    }
+
+    // Moving leaves `other` empty, so only one roster releases the names
+    Roster(Roster&&) noexcept = default;
+
+    Roster& operator=(const Roster& other) {
+        if (this != &other) *this = Roster(other);
+        return *this;
+    }
+
+    Roster& operator=(Roster&& other) noexcept {
+        if (this != &other) {
+            release_names();
+            steam_ids_ = std::move(other.steam_ids_);
+            names_ = std::move(other.names_);
+#define X(member, ...) member##_ = std::move(other.member##_);
+            PLAYER_STAT_FIELDS(X)
+#undef X
+        }
+        return *this;
+    }
+
+    ~Roster() { release_names(); }
+
+    void push_back(const PlayerStats& player) {
+        steam_ids_.push_back(player.steam_id.value());
+        names_.push_back(NameTable::global().intern(player.name));
+#define X(member, type, ...) member##_.push_back(static_cast<column_t<type>>(player.member));
+        PLAYER_STAT_FIELDS(X)
+#undef X
+    }
+
+    void reserve(size_t players) {
+        steam_ids_.reserve(players);
+        names_.reserve(players);
+#define X(member, ...) member##_.reserve(players);
+        PLAYER_STAT_FIELDS(X)
+#undef X
+    }
+
+    void clear() {
+        release_names();
+        steam_ids_.clear();
+        names_.clear();
+#define X(member, ...) member##_.clear();
+        PLAYER_STAT_FIELDS(X)
+#undef X
+    }
+
+    // Per-stat setters, e.g. set_won_match() once the final scores are in
+#define X(member, type, ...) \
+    void set_##member(size_t index, type value) { member##_[index] = static_cast<column_t<type>>(value); }
+    PLAYER_STAT_FIELDS(X)
+#undef X
+
+    size_t size() const { return steam_ids_.size(); }
+    bool empty() const { return size() == 0; }
+
+    PlayerRef operator[](size_t index) const { return PlayerRef(*this, index); }
+    const_iterator begin() const { return const_iterator(*this, 0); }
+    const_iterator end() const { return const_iterator(*this, size()); }
+
+    // Index of a player in the roster, if present
+    std::optional<size_t> find(SteamId steam_id) const {
+        const uint64_t* ids = steam_ids_.data();
+        for (size_t i = 0; i < size(); ++i) {
+            if (ids[i] == steam_id.value()) return i;
+        }
+        return std::nullopt;
+    }
+
+    // Raw column access (size() entries), e.g. kills_column()
+    const uint64_t* steam_id_column() const { return steam_ids_.data(); }
+    const std::string* const* name_column() const { return names_.data(); }
+#define X(member, type, ...) \
+    const column_t<type>* member##_column() const { return member##_.data(); }
+    PLAYER_STAT_FIELDS(X)
+#undef X
+
+    // Sum of one stat over the whole roster
+    double total(PlayerStat stat) const {
+        switch (stat) {
+#define X(member, ...) \
+            case PlayerStat::member: return sum(member##_.data());
+            PLAYER_STAT_FIELDS(X)
+#undef X
+            case PlayerStat::Count: break;
+        }
+        return 0.0;
+    }
+
+private:
+    friend class PlayerRef;
+    static constexpr size_t N = kInlinePlayers;
+
+    void release_names() {
+        if (names_.size() != 0) NameTable::global().release(names_.data(), names_.size());
+    }
+
+    template <typename T>
+    double sum(const T* values) const {
+        double total = 0.0;
+        for (size_t i = 0; i < size(); ++i) total += static_cast<double>(values[i]);
+        return total;
+    }
+
+    InlineColumn<uint64_t, N> steam_ids_;
+    InlineColumn<const std::string*, N> names_;
+#define X(member, type, ...) InlineColumn<column_t<type>, N> member##_;
+    PLAYER_STAT_FIELDS(X)
+#undef X
+};
+
+inline SteamId PlayerRef::steam_id() const { return SteamId(roster_->steam_ids_[index_]); }
+inline const std::string& PlayerRef::name() const { return *roster_->names_[index_]; }
+#define X(member, type, ...) \
+    inline type PlayerRef::member() const { return static_cast<type>(roster_->member##_[index_]); }
+PLAYER_STAT_FIELDS(X)
+#undef X
+
+inline PlayerStats PlayerRef::to_stats() const {
+    PlayerStats stats;
+    stats.steam_id = steam_id();
+    stats.name = name();
+#define X(member, ...) stats.member = member();
+    PLAYER_STAT_FIELDS(X)
+#undef X
+    return stats;
+}
+
+// Print the stats in `mask` (table order, labelled), e.g. with kInlineStats:
+// "K/D/A 21/14/3, ADR 88, HS% 52%, KD 1.50"
+void write_stats(std::ostream& out, PlayerRef player, StatMask mask,
+                 const StatStyle& style = kInlineStats);
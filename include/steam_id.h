@@ -0,0 +1,61 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/**
+ * A Steam64 ID. Parsed and validated once (config load, JSON parsing) and
+ * compared/hashed as a plain integer everywhere else. A default-constructed
+ * SteamId is invalid (zero).
+ */
+class SteamId {
+public:
+    constexpr SteamId() = default;
+    constexpr explicit SteamId(uint64_t value) : value_(value) {}
+
+    // Parse a decimal Steam64 ID; nullopt if it isn't a non-zero 64-bit number
+    static std::optional<SteamId> parse(std::string_view text) {
+        uint64_t value = 0;
+        const char* end = text.data() + text.size();
+        auto [ptr, ec] = std::from_chars(text.data(), end, value);
+        if (text.empty() || ec != std::errc() || ptr != end || value == 0) {
+            return std::nullopt;
+        }
+        return SteamId(value);
+    }
+
+    constexpr uint64_t value() const { return value_; }
+    constexpr bool is_valid() const { return value_ != 0; }
+
+    std::string to_string() const { return std::to_string(value_); }
+
+    constexpr bool operator==(SteamId other) const { return value_ == other.value_; }
+    constexpr bool operator!=(SteamId other) const { return value_ != other.value_; }
+    constexpr bool operator<(SteamId other) const { return value_ < other.value_; }
+
+private:
+    uint64_t value_ = 0;
+};
+
+inline std::ostream& operator<<(std::ostream& os, SteamId id) {
+    return os << id.value();
+}
+
+namespace std {
+template <>
+struct hash<SteamId> {
+    size_t operator()(SteamId id) const noexcept {
+        // Steam64 IDs share their high bits (universe/type), so mix before bucketing
+        uint64_t x = id.value();
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        return static_cast<size_t>(x);
+    }
+};
+}  // namespace std
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed-size pool of worker threads used to bound concurrent upstream requests.
+ * Tasks may submit further tasks; wait() blocks until the queue is drained and
+ * every worker is idle.
+ */
+class TaskPool {
+public:
+    explicit TaskPool(size_t num_threads) {
+        if (num_threads == 0) num_threads = 1;
+        workers_.reserve(num_threads);
+        for (size_t i = 0; i < num_threads; ++i) {
+            workers_.emplace_back([this] { worker_loop(); });
+        }
+    }
+
+    ~TaskPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        task_cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    // Queue a task for execution on the next free worker
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        task_cv_.notify_one();
+    }
+
+    // Block until all queued tasks (including ones they submit) have finished
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_cv_.wait(lock, [this] { return tasks_.empty() && active_ == 0; });
+    }
+
+    size_t size() const { return workers_.size(); }
+
+private:
+    void worker_loop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                task_cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+                if (stopping_ && tasks_.empty()) return;
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+                ++active_;
+            }
+
+            try {
+                task();
+            } catch (const std::exception& e) {
+                std::cerr << "[pool] Task threw exception: " << e.what() << "\n";
+            } catch (...) {
+                std::cerr << "[pool] Task threw unknown exception\n";
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --active_;
+                if (tasks_.empty() && active_ == 0) {
+                    idle_cv_.notify_all();
+                }
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable task_cv_;
+    std::condition_variable idle_cv_;
+    size_t active_ = 0;
+    bool stopping_ = false;
+};
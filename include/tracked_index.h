@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "steam_id.h"
+
+/**
+ * Immutable set of tracked Steam IDs, built once from the config.
+ * Open addressing with linear probing over a power-of-two table kept at most
+ * half full, so contains() is a hash plus (almost always) one or two probes
+ * into a flat array. Slot value 0 marks an empty slot (0 is never a valid
+ * SteamId).
+ */
+class TrackedIndex {
+public:
+    TrackedIndex() : slots_(1, 0), mask_(0) {}
+
+    explicit TrackedIndex(const std::vector<SteamId>& ids) {
+        size_t capacity = 2;
+        while (capacity < ids.size() * 2) capacity *= 2;
+        slots_.assign(capacity, 0);
+        mask_ = capacity - 1;
+
+        for (SteamId id : ids) {
+            if (!id.is_valid()) continue;
+            size_t slot = bucket(id);
+            while (slots_[slot] != 0 && slots_[slot] != id.value()) {
+                slot = (slot + 1) & mask_;
+            }
+            if (slots_[slot] == 0) {
+                slots_[slot] = id.value();
+                ++size_;
+            }
+        }
+    }
+
+    bool contains(SteamId id) const {
+        if (!id.is_valid()) return false;
+        for (size_t slot = bucket(id);; slot = (slot + 1) & mask_) {
+            if (slots_[slot] == id.value()) return true;
+            if (slots_[slot] == 0) return false;
+        }
+    }
+
+    // Number of distinct tracked IDs
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    size_t bucket(SteamId id) const { return std::hash<SteamId>()(id) & mask_; }
+
+    std::vector<uint64_t> slots_;
+    size_t mask_ = 0;
+    size_t size_ = 0;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+
+/**
+ * Process-wide per-endpoint byte counters for upstream HTTP traffic:
+ * bytes received on the wire versus bytes after Content-Encoding decoding.
+ */
+class TransferStats {
+public:
+    static TransferStats& global();
+
+    void record(const std::string& endpoint, size_t wire_bytes, size_t decoded_bytes);
+
+    // Print one line per endpoint
+    void log_summary() const;
+
+private:
+    struct Counters {
+        size_t responses = 0;
+        size_t wire_bytes = 0;
+        size_t decoded_bytes = 0;
+    };
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Counters> endpoints_;
+};
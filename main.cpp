@@ -1,16 +1,29 @@
+#include <algorithm>
 #include <iostream>
 #include <thread>
 #include <chrono>
 #include <csignal>
 #include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
 
 #include "config.h"
 #include "leetify_client.h"
 #include "discord_client.h"
 #include "ai_client.h"
+#include "json_scan.h"
+#include "match_arena.h"
 #include "match_data.h"
 #include "persistence.h"
+#include "player_cursors.h"
+#include "match_poller.h"
+#include "poll_planner.h"
+#include "poll_scheduler.h"
+#include "task_pool.h"
+#include "tracked_index.h"
+#include "transfer_stats.h"
 
 // Global flag for graceful shutdown (Ctrl+C)
 std::atomic<bool> g_running{true};
@@ -52,38 +65,127 @@ int main() {
     for (const auto& id : config.tracked_steam_ids) {
         std::cout << "  - " << id << "\n";
     }
-    std::cout << "Poll interval: " << config.poll_interval_seconds << " seconds\n\n";
+    std::cout << "Poll interval: " << config.poll_interval_seconds << " seconds (active "
+              << config.active_poll_interval_seconds << "s, idle up to "
+              << config.max_poll_interval_seconds << "s)\n";
+    std::cout << "Poll concurrency: " << config.poll_concurrency << "\n";
+    if (config.leetify_requests_per_minute > 0) {
+        std::cout << "Leetify budget: " << config.leetify_requests_per_minute << " requests/minute\n";
+    }
+    if (config.leetify_hedge_percentile > 0) {
+        std::cout << "Hedging match-detail requests slower than p" << config.leetify_hedge_percentile << "\n";
+    }
+    std::cout << "\n";
     
+    // O(1) "is this player tracked?" lookups for every match
+    const TrackedIndex tracked(config.tracked_steam_ids);
+
     // Initialize clients
     LeetifyClient leetify_client(config.leetify_api_key);
+    auto leetify_limiter = std::make_shared<RateLimiter>(config.leetify_requests_per_minute,
+                                                         config.leetify_burst);
+    leetify_client.set_rate_limiter(leetify_limiter);
+    leetify_client.set_hedging(config.leetify_hedge_percentile);
+    leetify_client.set_fast_json(config.fast_json_parser);
+    leetify_client.set_extended_stats(config.extended_stats);
+    if (config.fast_json_parser || config.extended_stats) {
+        std::cout << "[leetify] Fast JSON parser on (" << json_scan_backend() << ")\n";
+    }
+
+    std::shared_ptr<MatchCache> match_cache;
+    if (config.match_cache_max_mb > 0) {
+        match_cache = std::make_shared<MatchCache>(config.match_cache_dir,
+                                                   static_cast<size_t>(config.match_cache_max_mb) * 1024 * 1024);
+        match_cache->load();
+        leetify_client.set_match_cache(match_cache);
+    }
     DiscordClient discord_client(config.discord_webhook_url);
     OpenAIClient openai_client(config.openai_api_key);
+    leetify_client.set_compression(config.http_compression);
+    discord_client.set_compression(config.http_compression);
+    openai_client.set_compression(config.http_compression);
     
     // Load persistence (remembered match IDs)
-    PersistenceManager persistence("seen_matches.txt");
+    PersistenceManager persistence("seen_matches.bin", "seen_matches.txt");
     persistence.load();
 
+    // Each player's newest known match and when their list was last read
+    PlayerCursorStore cursors("player_cursors.txt");
+    cursors.load();
+
     // Silent initialization: if this is a fresh start (no seen matches),
     // mark current matches as seen without posting to avoid stale match spam
     if (persistence.is_empty()) {
         std::cout << "[init] First run detected - performing silent initialization...\n";
         std::cout << "[init] Marking current matches as seen (won't post stale matches)\n";
 
-        for (const auto& steam_id : config.tracked_steam_ids) {
-            std::cout << "[init] Checking current match for Steam ID: " << steam_id << "\n";
-            MatchData match = leetify_client.fetch_recent_match(steam_id);
-
-            if (!match.match_id.empty()) {
-                std::cout << "[init]   -> Marking match " << match.match_id << " as seen\n";
-                persistence.mark_seen_and_save(match.match_id);
-            } else {
-                std::cout << "[init]   -> No match found for this player\n";
+        // Only the match list is needed here (no details), fetched in parallel
+        std::mutex init_mutex;
+        std::vector<std::string> newest_ids;
+        int64_t init_at = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        {
+            TaskPool init_pool(static_cast<size_t>(config.poll_concurrency));
+            for (const auto& steam_id : config.tracked_steam_ids) {
+                init_pool.submit([&, steam_id] {
+                    // Only the newest entry matters; the rest of the list isn't parsed
+                    std::vector<MatchListEntry> entries = leetify_client.fetch_recent_matches(
+                        steam_id, [](const MatchListEntry&) { return true; });
+                    if (entries.empty()) {
+                        std::cout << "[init]   -> No match found for Steam ID " + steam_id.to_string() + "\n";
+                        return;
+                    }
+                    std::cout << "[init]   -> Marking match " + entries.front().id + " of Steam ID " +
+                                 steam_id.to_string() + " as seen\n";
+                    cursors.update(steam_id, entries.front().id, entries.front().finished_at, init_at);
+                    std::lock_guard<std::mutex> lock(init_mutex);
+                    newest_ids.push_back(entries.front().id);
+                });
             }
+            init_pool.wait();
+        }
+
+        for (const auto& match_id : newest_ids) {
+            persistence.mark_seen(match_id);
         }
+        persistence.save();
+        cursors.save();
 
         std::cout << "[init] Silent initialization complete. Only new matches will be posted.\n\n";
     }
 
+    MatchPoller poller(leetify_client, persistence, cursors,
+                       config.poll_concurrency, config.catchup_max_matches);
+
+    // Players with a saved cursor resume their schedule where it left off (no
+    // network calls at startup); everyone else is due immediately. After that
+    // each player runs on their own interval.
+    PollScheduler scheduler(config.poll_interval_seconds,
+                            config.active_poll_interval_seconds,
+                            config.max_poll_interval_seconds);
+    auto startup = PollScheduler::Clock::now();
+    int64_t startup_unix = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    size_t resumed = 0;
+    for (const auto& steam_id : config.tracked_steam_ids) {
+        auto first_due = startup;
+        if (auto cursor = cursors.get(steam_id)) {
+            int64_t since_poll = std::max<int64_t>(0, startup_unix - cursor->polled_at);
+            first_due += std::chrono::seconds(std::max<int64_t>(0, config.poll_interval_seconds - since_poll));
+            ++resumed;
+        }
+        scheduler.add_player(steam_id, first_due);
+    }
+    if (resumed > 0) {
+        std::cout << "[init] Resumed " << resumed << " player(s) from saved cursors\n";
+    }
+
+    // Rations due polls against the Leetify budget, best expected value first
+    PollPlanner planner(config.leetify_requests_per_minute);
+    poller.set_list_observer([&planner](SteamId steam_id, const std::vector<MatchListEntry>& entries) {
+        planner.observe_matches(steam_id, entries);
+    });
+
     // Send startup message to Discord
     discord_client.send_message("🎮 CS2 Match Tracker is now online! Monitoring " +
                                 std::to_string(config.tracked_steam_ids.size()) + " player(s).");
@@ -92,44 +194,59 @@ int main() {
     
     // Main polling loop
     while (g_running) {
-        try {
-            // Phase 1: Collect all new matches from all tracked players
-            // Use map to deduplicate by match_id
-            std::map<std::string, MatchData> new_matches;
-
-            for (const auto& steam_id : config.tracked_steam_ids) {
-                if (!g_running) break;
-
-                std::cout << "[poll] Checking for new matches for Steam ID: " << steam_id << "\n";
+        std::vector<SteamId> due_ids = scheduler.pop_due(PollScheduler::Clock::now());
+        if (!due_ids.empty()) {
+            std::vector<SteamId> deferred_ids;
+            due_ids = planner.plan(due_ids, deferred_ids);
+            auto retry_at = PollScheduler::Clock::now() + std::chrono::seconds(planner.retry_delay_seconds());
+            for (const auto& steam_id : deferred_ids) {
+                scheduler.postpone(steam_id, retry_at);
+            }
+        }
+        // Tracked players who appeared in a new match this cycle
+        std::unordered_set<SteamId> active_ids;
 
-                // Fetch the most recent match
-                MatchData match = leetify_client.fetch_recent_match(steam_id);
+        try {
+            // Phase 1: Collect all new matches from the players that are due (in parallel)
+            // Results are deduplicated by match_id and ordered oldest first
+            std::vector<MatchSnapshot> new_matches;
+            if (!due_ids.empty()) {
+                new_matches = poller.poll(due_ids, g_running);
+            }
 
-                if (match.match_id.empty()) {
-                    std::cout << "  -> No match found or fetch failed\n";
-                    continue;
+            for (const auto& match : new_matches) {
+                for (PlayerRef player : match->get_tracked_players(tracked)) {
+                    active_ids.insert(player.steam_id());
+                    planner.record_detection(player.steam_id(), match->game_finished_at);
                 }
-
-                // Check if we've already processed this match
-                if (persistence.has_seen(match.match_id)) {
-                    std::cout << "  -> Match " << match.match_id << " already processed, skipping\n";
-                    continue;
+            }
+            if (!due_ids.empty()) {
+                cursors.save();
+                // List polls were charged up front: refund the ones co-play made
+                // unnecessary, and charge only the detail fetches that hit the network
+                const PollCycleStats& cycle_stats = poller.last_cycle_stats();
+                planner.refund(cycle_stats.polls_saved);
+                planner.charge(cycle_stats.detail_requests);
+                planner.log_summary();
+                leetify_limiter->log_summary();
+                if (match_cache) match_cache->log_summary();
+                if (config.leetify_hedge_percentile > 0) {
+                    std::cout << "[leetify] Hedges: " << leetify_client.hedges_issued() << " sent, "
+                              << leetify_client.hedges_won() << " won\n";
                 }
-
-                // Check if we already collected this match from another player
-                if (new_matches.find(match.match_id) != new_matches.end()) {
-                    std::cout << "  -> Match " << match.match_id << " already collected from another player\n";
-                    continue;
+                if (config.fast_json_parser || config.extended_stats) {
+                    std::cout << "[leetify] Fast JSON parser: " << leetify_client.fast_parses() << " parsed, "
+                              << leetify_client.fast_parse_fallbacks() << " fell back to nlohmann\n";
                 }
-
-                // New match found - add to collection
-                std::cout << "  -> New match found: " << match.match_id << " on " << match.map_name << "\n";
-                new_matches[match.match_id] = match;
+                TransferStats::global().log_summary();
             }
 
             // Phase 2: Process each unique new match
-            for (auto& [match_id, match] : new_matches) {
+            for (const MatchSnapshot& snapshot : new_matches) {
                 if (!g_running) break;
+                const MatchData& match = *snapshot;
+                // Scratch memory for this match, released in one go at the end of the iteration
+                MatchArena arena;
 
                 std::cout << "\n*** PROCESSING NEW MATCH ***\n";
                 std::cout << "  Match ID: " << match.match_id << "\n";
@@ -137,7 +254,7 @@ int main() {
                 std::cout << "  Score: " << match.get_score_string() << "\n";
 
                 // Get ALL tracked players' stats from this match
-                auto tracked_players = match.get_tracked_players(config.tracked_steam_ids);
+                auto tracked_players = match.get_tracked_players(tracked, arena.resource());
 
                 if (tracked_players.empty()) {
                     std::cout << "  -> No tracked players found in match (unexpected)\n";
@@ -147,44 +264,44 @@ int main() {
 
                 // Print tracked player stats
                 std::cout << "  Tracked players in this match: " << tracked_players.size() << "\n";
-                for (const auto& player : tracked_players) {
-                    std::cout << "    " << player.name
-                              << " - K/D/A: " << player.kills << "/" << player.deaths << "/" << player.assists
-                              << " | ADR: " << player.adr
-                              << " | HS%: " << player.headshot_percentage << "%"
-                              << " | " << (player.won_match ? "WIN" : "LOSS") << "\n";
+                for (PlayerRef player : tracked_players) {
+                    std::cout << "    " << player.name() << " - ";
+                    write_stats(std::cout, player, kAllShownStats, kLogStats);
+                    std::cout << " | " << (player.won_match() ? "WIN" : "LOSS") << "\n";
                 }
 
                 // Generate AI comments for all tracked players
                 std::cout << "\n  -> Generating AI commentary for " << tracked_players.size() << " player(s)...\n";
 
-                std::map<std::string, std::string> player_comments;
+                std::map<SteamId, std::string> player_comments;
                 bool use_multi_player_report = tracked_players.size() > 1;
 
                 if (use_multi_player_report) {
                     // Multiple tracked players - generate individual comments
-                    player_comments = openai_client.generate_multi_player_comments(match, tracked_players);
+                    player_comments = openai_client.generate_multi_player_comments(match, tracked_players, tracked,
+                                                                                     arena.resource());
 
                     // Check if generation worked, fallback if needed
-                    for (const auto& player : tracked_players) {
-                        auto it = player_comments.find(player.steam_id);
+                    for (PlayerRef player : tracked_players) {
+                        auto it = player_comments.find(player.steam_id());
                         if (it == player_comments.end() || it->second.empty() ||
                             it->second == "Error generating comment") {
-                            std::cerr << "  -> Fallback comment for " << player.name << "\n";
-                            player_comments[player.steam_id] = player.name + " went " +
-                                std::to_string(player.kills) + "/" + std::to_string(player.deaths) +
-                                ". " + (player.won_match ? "At least they won!" : "Rough game.");
+                            std::cerr << "  -> Fallback comment for " << player.name() << "\n";
+                            player_comments[player.steam_id()] = player.name() + " went " +
+                                std::to_string(player.kills()) + "/" + std::to_string(player.deaths()) +
+                                ". " + (player.won_match() ? "At least they won!" : "Rough game.");
                         }
                     }
 
                     // Print comments
-                    for (const auto& player : tracked_players) {
-                        std::cout << "  -> " << player.name << ": " << player_comments[player.steam_id] << "\n";
+                    for (PlayerRef player : tracked_players) {
+                        std::cout << "  -> " << player.name() << ": " << player_comments[player.steam_id()] << "\n";
                     }
 
                     // Send multi-player report to Discord
                     std::cout << "  -> Sending multi-player report to Discord...\n";
-                    bool discord_success = discord_client.send_multi_player_report(match, tracked_players, player_comments);
+                    bool discord_success = discord_client.send_multi_player_report(match, tracked_players, player_comments,
+                                                                                   arena.resource());
 
                     if (discord_success) {
                         std::cout << "  -> Successfully posted to Discord!\n";
@@ -193,21 +310,21 @@ int main() {
                     }
                 } else {
                     // Single tracked player - use original flow
-                    std::string comment = openai_client.generate_match_comment(match, config.tracked_steam_ids);
+                    std::string comment = openai_client.generate_match_comment(match, tracked, arena.resource());
 
                     if (comment.empty() || comment == "Error generating comment") {
                         std::cerr << "  -> Failed to generate AI comment, using fallback\n";
-                        const auto& p = tracked_players[0];
-                        comment = p.name + " just finished a game on " + match.map_name +
-                                  " with a " + std::to_string(p.kills) + "/" + std::to_string(p.deaths) +
-                                  " K/D. " + (p.won_match ? "They won!" : "Tough loss.");
+                        PlayerRef p = tracked_players[0];
+                        comment = p.name() + " just finished a game on " + match.map_name +
+                                  " with a " + std::to_string(p.kills()) + "/" + std::to_string(p.deaths()) +
+                                  " K/D. " + (p.won_match() ? "They won!" : "Tough loss.");
                     }
 
                     std::cout << "  -> AI Comment: " << comment << "\n";
 
                     // Send to Discord
                     std::cout << "  -> Sending to Discord...\n";
-                    bool discord_success = discord_client.send_match_report(match, comment);
+                    bool discord_success = discord_client.send_match_report(match, comment, arena.resource());
 
                     if (discord_success) {
                         std::cout << "  -> Successfully posted to Discord!\n";
@@ -218,6 +335,7 @@ int main() {
 
                 // Mark match as seen (so we don't process it again)
                 persistence.mark_seen_and_save(match.match_id);
+                arena.log_summary(match.match_id);
                 std::cout << "  -> Match marked as processed\n\n";
 
                 // Small delay between processing matches
@@ -229,9 +347,29 @@ int main() {
             discord_client.send_message("⚠️ Error in match tracker: " + std::string(e.what()));
         }
 
-        // Wait before next poll (interruptible for quick shutdown)
-        std::cout << "[poll] Waiting " << config.poll_interval_seconds << " seconds until next check...\n";
-        for (int i = 0; i < config.poll_interval_seconds && g_running; ++i) {
+        // Reschedule: players with a new match get polled again soon, idle ones back off,
+        // and failed detail fetches are retried soon. Players seen in someone else's new
+        // match are pulled forward too.
+        auto now = PollScheduler::Clock::now();
+        const std::unordered_set<SteamId>& failed_ids = poller.last_failed_players();
+        for (const auto& steam_id : due_ids) {
+            PollOutcome outcome = active_ids.count(steam_id) > 0  ? PollOutcome::NewMatch
+                                : failed_ids.count(steam_id) > 0 ? PollOutcome::FetchFailed
+                                                                 : PollOutcome::NothingNew;
+            scheduler.record_poll(steam_id, outcome, now);
+            active_ids.erase(steam_id);
+        }
+        for (const auto& steam_id : active_ids) {
+            scheduler.record_poll(steam_id, PollOutcome::NewMatch, now);
+        }
+
+        // Wait until the next player is due (interruptible for quick shutdown)
+        auto next_due = scheduler.next_due();
+        if (!due_ids.empty() && next_due) {
+            auto wait = std::chrono::duration_cast<std::chrono::seconds>(*next_due - now);
+            std::cout << "[poll] Next check in " << std::max<long long>(0, wait.count()) << " seconds\n";
+        }
+        while (g_running && next_due && PollScheduler::Clock::now() < *next_due) {
             std::this_thread::sleep_for(std::chrono::seconds(1));
         }
     }
@@ -239,6 +377,7 @@ int main() {
     // Cleanup
     std::cout << "\n[main] Saving state and shutting down...\n";
     persistence.save();
+    cursors.save();
     discord_client.send_message("👋 CS2 Match Tracker is going offline.");
     
     std::cout << "[main] Goodbye!\n";
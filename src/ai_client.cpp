@@ -1,27 +1,42 @@
 #define CPPHTTPLIB_OPENSSL_SUPPORT
 #include "ai_client.h"
 #include "httplib.h"
+#include "compression.h"
+#include "match_arena.h"
+#include "transfer_stats.h"
 #include <iostream>
-#include <sstream>
-#include <iomanip>
 #include <nlohmann/json.hpp>
 #include <regex>
 
 using json = nlohmann::json;
 
+namespace {
+
+// Which stats each kind of prompt line shows
+constexpr StatMask kTrackedStats = kAllShownStats;
+constexpr StatMask kLobbyStats = kKdaStats | stat_bit(PlayerStat::adr) | stat_bit(PlayerStat::kd_ratio);
+constexpr StatMask kOtherStats = kKdaStats | stat_bit(PlayerStat::adr);
+constexpr StatMask kSinglePlayerStats =
+    kKdaStats | stat_bit(PlayerStat::adr) | stat_bit(PlayerStat::headshot_percentage);
+
+}  // namespace
+
 AIClient::AIClient(const std::string& api_key) : api_key_(api_key) {}
 
-std::string AIClient::generate_match_comment(const MatchData& match,
-                                             const std::vector<std::string>& tracked_steam_ids) {
-    std::string prompt = build_comment_prompt(match, tracked_steam_ids);
-    return make_api_request(prompt);
+std::string AIClient::generate_match_comment(const MatchData& match, const TrackedIndex& tracked,
+                                             std::pmr::memory_resource* memory) {
+    ArenaOStream prompt(memory);
+    build_comment_prompt(prompt, match, tracked, memory);
+    return make_api_request(prompt.view());
 }
 
-std::map<std::string, std::string> AIClient::generate_multi_player_comments(
+std::map<SteamId, std::string> AIClient::generate_multi_player_comments(
     const MatchData& match,
-    const std::vector<PlayerStats>& tracked_players) {
+    const PlayerViews& tracked_players,
+    const TrackedIndex& tracked,
+    std::pmr::memory_resource* memory) {
 
-    std::map<std::string, std::string> result;
+    std::map<SteamId, std::string> result;
 
     if (tracked_players.empty()) {
         return result;
@@ -29,21 +44,22 @@ std::map<std::string, std::string> AIClient::generate_multi_player_comments(
 
     // If only one tracked player, use the simpler single-player method
     if (tracked_players.size() == 1) {
-        std::string comment = generate_player_comment(tracked_players[0], match);
-        result[tracked_players[0].steam_id] = comment;
+        std::string comment = generate_player_comment(tracked_players[0], match, memory);
+        result[tracked_players[0].steam_id()] = comment;
         return result;
     }
 
     // Build prompt for multiple players
-    std::string prompt = build_multi_player_prompt(match, tracked_players);
-    std::string response = make_api_request(prompt);
+    ArenaOStream prompt(memory);
+    build_multi_player_prompt(prompt, match, tracked_players, tracked, memory);
+    std::string response = make_api_request(prompt.view());
 
     // Parse the response - expect format like:
     // [PlayerName1]: comment here
     // [PlayerName2]: comment here
-    for (const auto& player : tracked_players) {
+    for (PlayerRef player : tracked_players) {
         // Try to find this player's section in the response
-        std::string pattern = "\\[" + player.name + "\\]:?\\s*";
+        std::string pattern = "\\[" + player.name() + "\\]:?\\s*";
         std::regex player_regex(pattern, std::regex::icase);
         std::smatch match_result;
 
@@ -53,9 +69,9 @@ std::map<std::string, std::string> AIClient::generate_multi_player_comments(
             // Find where the next player's comment starts (or end of string)
             size_t end = response.length();
 
-            for (const auto& other : tracked_players) {
-                if (other.steam_id == player.steam_id) continue;
-                std::string other_pattern = "\\[" + other.name + "\\]:?";
+            for (PlayerRef other : tracked_players) {
+                if (other.steam_id() == player.steam_id()) continue;
+                std::string other_pattern = "\\[" + other.name() + "\\]:?";
                 std::regex other_regex(other_pattern, std::regex::icase);
                 std::smatch other_match;
                 std::string remaining = response.substr(start);
@@ -74,24 +90,24 @@ std::map<std::string, std::string> AIClient::generate_multi_player_comments(
             if (first != std::string::npos && last != std::string::npos) {
                 comment = comment.substr(first, last - first + 1);
             }
-            result[player.steam_id] = comment;
+            result[player.steam_id()] = comment;
         }
     }
 
     // Fallback: if parsing failed for any player, generate individual comments
-    for (const auto& player : tracked_players) {
-        if (result.find(player.steam_id) == result.end() || result[player.steam_id].empty()) {
-            std::cout << "  -> Fallback: generating individual comment for " << player.name << "\n";
-            result[player.steam_id] = generate_player_comment(player, match);
+    for (PlayerRef player : tracked_players) {
+        if (result.find(player.steam_id()) == result.end() || result[player.steam_id()].empty()) {
+            std::cout << "  -> Fallback: generating individual comment for " << player.name() << "\n";
+            result[player.steam_id()] = generate_player_comment(player, match, memory);
         }
     }
 
     return result;
 }
 
-std::string AIClient::build_multi_player_prompt(const MatchData& match,
-                                                const std::vector<PlayerStats>& tracked_players) {
-    std::ostringstream prompt;
+void AIClient::build_multi_player_prompt(std::ostream& prompt, const MatchData& match,
+                                         const PlayerViews& tracked_players,
+                                         const TrackedIndex& tracked, std::pmr::memory_resource* memory) {
     prompt << "You are a SAVAGE CS2 match commentator for a Discord server full of friends who roast each other. ";
     prompt << "Write SHORT but BRUTAL comments for EACH of the tracked players below. ";
     prompt << "If someone did BAD: be absolutely ruthless - question their skill, mock their stats, suggest they uninstall, ";
@@ -101,8 +117,8 @@ std::string AIClient::build_multi_player_prompt(const MatchData& match,
     prompt << "Keep each comment to 1-2 sentences. Reference specific stats to make the roasts/praise hit harder!\n\n";
 
     prompt << "IMPORTANT: Format your response EXACTLY like this, with each player on their own line:\n";
-    for (const auto& player : tracked_players) {
-        prompt << "[" << player.name << "]: (your comment here)\n";
+    for (PlayerRef player : tracked_players) {
+        prompt << "[" << player.name() << "]: (your comment here)\n";
     }
     prompt << "\n";
 
@@ -111,64 +127,57 @@ std::string AIClient::build_multi_player_prompt(const MatchData& match,
     prompt << "Score: " << match.get_score_string() << "\n\n";
 
     prompt << "=== TRACKED PLAYERS ===\n";
-    for (const auto& player : tracked_players) {
-        prompt << "- " << player.name << ": ";
-        prompt << "K/D/A " << player.kills << "/" << player.deaths << "/" << player.assists;
-        prompt << ", ADR " << player.adr;
-        prompt << ", HS% " << player.headshot_percentage << "%";
-        prompt << ", KD " << std::fixed << std::setprecision(2) << player.kd_ratio;
-        prompt << " (" << (player.won_match ? "WON" : "LOST") << ")\n";
+    for (PlayerRef player : tracked_players) {
+        prompt << "- " << player.name() << ": ";
+        write_stats(prompt, player, kTrackedStats);
+        write_extended_stats(prompt, match.extended, player.index());
+        prompt << " (" << (player.won_match() ? "WON" : "LOST") << ")\n";
     }
 
     // Add context about other players
-    std::vector<const PlayerStats*> others;
-    for (const auto& player : match.players) {
-        bool is_tracked = false;
-        for (const auto& tp : tracked_players) {
-            if (player.steam_id == tp.steam_id) {
-                is_tracked = true;
-                break;
-            }
-        }
-        if (!is_tracked) {
-            others.push_back(&player);
+    PlayerViews others(memory);
+    for (PlayerRef player : match.players) {
+        if (!tracked.contains(player.steam_id())) {
+            others.push_back(player);
         }
     }
 
     if (!others.empty()) {
         prompt << "\n=== OTHER PLAYERS (for context) ===\n";
-        for (const auto* player : others) {
-            prompt << "- " << player->name << ": ";
-            prompt << "K/D/A " << player->kills << "/" << player->deaths << "/" << player->assists;
-            prompt << ", ADR " << player->adr << "\n";
+        for (PlayerRef player : others) {
+            prompt << "- " << player.name() << ": ";
+            write_stats(prompt, player, kOtherStats);
+            prompt << "\n";
         }
     }
 
     prompt << "\nNow write a short, witty comment for each tracked player:";
-    return prompt.str();
 }
 
-std::string AIClient::generate_player_comment(const PlayerStats& player, const MatchData& match) {
-    std::ostringstream prompt;
+std::string AIClient::generate_player_comment(PlayerRef player, const MatchData& match,
+                                              std::pmr::memory_resource* memory) {
+    ArenaOStream prompt(memory);
+    build_player_prompt(prompt, player, match);
+    return make_api_request(prompt.view());
+}
+
+void AIClient::build_player_prompt(std::ostream& prompt, PlayerRef player, const MatchData& match) {
     prompt << "Write a SAVAGE comment (1-2 sentences) about this CS2 match performance. ";
     prompt << "If they did BAD: be absolutely BRUTAL - mock their stats, question if they were AFK, ";
     prompt << "suggest they uninstall, say they got carried, compare them to Silver players. Be MEAN. ";
     prompt << "If they did GOOD: worship them like a god - full simp mode, call them insane, ";
     prompt << "say they hard carried, compare them to pro players, glaze them hard. ";
-    prompt << "Player: " << player.name << "\n";
-    prompt << "K/D: " << player.kills << "/" << player.deaths << "\n";
-    prompt << "ADR: " << player.adr << "\n";
-    prompt << "Headshot %: " << player.headshot_percentage << "%\n";
-    prompt << "Match result: " << (player.won_match ? "Won" : "Lost") << "\n";
+    prompt << "Player: " << player.name() << "\n";
+    write_stats(prompt, player, kSinglePlayerStats, kListStats);
+    write_extended_stats(prompt, match.extended, player.index(), kListStats);
+    prompt << "\n";
+    prompt << "Match result: " << (player.won_match() ? "Won" : "Lost") << "\n";
     prompt << "Map: " << match.map_name << "\n";
     prompt << "Reference their specific stats to make it hit harder!";
-
-    return make_api_request(prompt.str());
 }
 
-std::string AIClient::build_comment_prompt(const MatchData& match,
-                                           const std::vector<std::string>& tracked_steam_ids) {
-    std::ostringstream prompt;
+void AIClient::build_comment_prompt(std::ostream& prompt, const MatchData& match,
+                                    const TrackedIndex& tracked, std::pmr::memory_resource* memory) {
     prompt << "You are a SAVAGE CS2 match commentator for a Discord server full of friends who love roasting each other. ";
     prompt << "Write a BRUTAL or WORSHIPING comment about this CS2 match. ";
     prompt << "Focus mainly on the TRACKED players but feel free to roast enemies who dominated them, ";
@@ -184,78 +193,67 @@ std::string AIClient::build_comment_prompt(const MatchData& match,
     prompt << "Score: " << match.get_score_string() << "\n\n";
     
     // Get tracked players
-    auto tracked_players = match.get_tracked_players(tracked_steam_ids);
+    auto tracked_players = match.get_tracked_players(tracked, memory);
     
     // Figure out which team the tracked players are on
     int tracked_team = -1;
     if (!tracked_players.empty()) {
-        tracked_team = tracked_players[0].team_number;
+        tracked_team = tracked_players[0].team_number();
     }
     
     // Print tracked players first
     prompt << "=== TRACKED PLAYERS (the ones we care about) ===\n";
-    for (const auto& player : tracked_players) {
-        prompt << "- " << player.name << ": ";
-        prompt << "K/D/A " << player.kills << "/" << player.deaths << "/" << player.assists;
-        prompt << ", ADR " << player.adr;
-        prompt << ", HS% " << player.headshot_percentage << "%";
-        prompt << ", KD " << std::fixed << std::setprecision(2) << player.kd_ratio;
-        prompt << " (" << (player.won_match ? "WON" : "LOST") << ")\n";
+    for (PlayerRef player : tracked_players) {
+        prompt << "- " << player.name() << ": ";
+        write_stats(prompt, player, kTrackedStats);
+        write_extended_stats(prompt, match.extended, player.index());
+        prompt << " (" << (player.won_match() ? "WON" : "LOST") << ")\n";
     }
     
     // Separate teammates and enemies
-    std::vector<const PlayerStats*> teammates;
-    std::vector<const PlayerStats*> enemies;
+    PlayerViews teammates(memory);
+    PlayerViews enemies(memory);
     
-    for (const auto& player : match.players) {
+    for (PlayerRef player : match.players) {
         // Skip tracked players (already printed)
-        bool is_tracked = false;
-        for (const auto& id : tracked_steam_ids) {
-            if (player.steam_id == id) {
-                is_tracked = true;
-                break;
-            }
-        }
-        if (is_tracked) continue;
+        if (tracked.contains(player.steam_id())) continue;
         
-        if (player.team_number == tracked_team) {
-            teammates.push_back(&player);
+        if (player.team_number() == tracked_team) {
+            teammates.push_back(player);
         } else {
-            enemies.push_back(&player);
+            enemies.push_back(player);
         }
     }
     
     // Print teammates
     if (!teammates.empty()) {
         prompt << "\n=== TEAMMATES ===\n";
-        for (const auto* player : teammates) {
-            prompt << "- " << player->name << ": ";
-            prompt << "K/D/A " << player->kills << "/" << player->deaths << "/" << player->assists;
-            prompt << ", ADR " << player->adr;
-            prompt << ", KD " << std::fixed << std::setprecision(2) << player->kd_ratio << "\n";
+        for (PlayerRef player : teammates) {
+            prompt << "- " << player.name() << ": ";
+            write_stats(prompt, player, kLobbyStats);
+            prompt << "\n";
         }
     }
     
     // Print enemies
     if (!enemies.empty()) {
         prompt << "\n=== ENEMIES ===\n";
-        for (const auto* player : enemies) {
-            prompt << "- " << player->name << ": ";
-            prompt << "K/D/A " << player->kills << "/" << player->deaths << "/" << player->assists;
-            prompt << ", ADR " << player->adr;
-            prompt << ", KD " << std::fixed << std::setprecision(2) << player->kd_ratio << "\n";
+        for (PlayerRef player : enemies) {
+            prompt << "- " << player.name() << ": ";
+            write_stats(prompt, player, kLobbyStats);
+            prompt << "\n";
         }
     }
     
     prompt << "\nWrite a witty comment (focus on tracked players but mention standout enemies/teammates if relevant):";
-    return prompt.str();
 }
 
-std::string AIClient::make_api_request(const std::string& prompt) {
+std::string AIClient::make_api_request(std::string_view prompt) {
     // Use Groq API (free tier with Llama models)
     httplib::SSLClient cli("api.groq.com", 443);
     cli.set_connection_timeout(30, 0);
     cli.set_read_timeout(30, 0);
+    cli.set_decompress(false);
 
     // Build JSON request body (OpenAI-compatible format)
     json request_body;
@@ -284,6 +282,9 @@ std::string AIClient::make_api_request(const std::string& prompt) {
         {"Content-Type", "application/json"},
         {"Authorization", "Bearer " + api_key_}
     };
+    if (compression_) {
+        headers.emplace("Accept-Encoding", "gzip, deflate");
+    }
 
     auto res = cli.Post("/openai/v1/chat/completions", headers, body, "application/json");
     
@@ -292,6 +293,13 @@ std::string AIClient::make_api_request(const std::string& prompt) {
         return "Error generating comment";
     }
     
+    size_t wire_bytes = res->body.size();
+    if (!decode_content_encoding(res->body, res->get_header_value("Content-Encoding"))) {
+        std::cerr << "  -> Failed to decode compressed Groq response\n";
+        return "Error generating comment";
+    }
+    TransferStats::global().record("groq /openai/v1/chat/completions", wire_bytes, res->body.size());
+
     std::cout << "  -> Response status: " << res->status << "\n";
     
     if (res->status != 200) {
@@ -0,0 +1,85 @@
+#include "compression.h"
+#include <zlib.h>
+
+std::string gzip_compress(const std::string& data) {
+    z_stream stream{};
+    // 15 window bits + 16 = gzip header
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return {};
+    }
+
+    std::string out;
+    out.resize(deflateBound(&stream, static_cast<uLong>(data.size())) + 32);
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    stream.avail_out = static_cast<uInt>(out.size());
+
+    int ret = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+    if (ret != Z_STREAM_END) {
+        return {};
+    }
+
+    out.resize(stream.total_out);
+    return out;
+}
+
+namespace {
+
+std::optional<std::string> inflate_buffer(const std::string& data, int window_bits) {
+    z_stream stream{};
+    if (inflateInit2(&stream, window_bits) != Z_OK) {
+        return std::nullopt;
+    }
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+
+    std::string out;
+    char buffer[16384];
+    int ret = Z_OK;
+    while (ret == Z_OK) {
+        stream.next_out = reinterpret_cast<Bytef*>(buffer);
+        stream.avail_out = sizeof(buffer);
+        ret = inflate(&stream, Z_NO_FLUSH);
+        if (ret != Z_OK && ret != Z_STREAM_END) {
+            inflateEnd(&stream);
+            return std::nullopt;
+        }
+        out.append(buffer, sizeof(buffer) - stream.avail_out);
+        if (ret == Z_OK && stream.avail_in == 0 && stream.avail_out != 0) {
+            // Truncated input
+            inflateEnd(&stream);
+            return std::nullopt;
+        }
+    }
+
+    inflateEnd(&stream);
+    return out;
+}
+
+}  // namespace
+
+std::optional<std::string> gzip_decompress(const std::string& data) {
+    // 15 window bits + 32 = auto-detect gzip or zlib header
+    return inflate_buffer(data, 15 + 32);
+}
+
+bool decode_content_encoding(std::string& body, const std::string& content_encoding) {
+    if (content_encoding.empty() || content_encoding == "identity") return true;
+
+    std::optional<std::string> decoded;
+    if (content_encoding == "gzip" || content_encoding == "x-gzip") {
+        decoded = gzip_decompress(body);
+    } else if (content_encoding == "deflate") {
+        // Should be zlib-wrapped, but some servers send raw deflate
+        decoded = gzip_decompress(body);
+        if (!decoded) decoded = inflate_buffer(body, -15);
+    }
+
+    if (!decoded) return false;
+    body = std::move(*decoded);
+    return true;
+}
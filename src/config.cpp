@@ -60,6 +60,62 @@ void Config::load_from_env_file(Config& config) {
             } catch (...) {
                 std::cerr << "[config] Invalid POLL_INTERVAL_SECONDS, using default\n";
             }
+        } else if (key == "ACTIVE_POLL_INTERVAL_SECONDS") {
+            try {
+                config.active_poll_interval_seconds = std::stoi(value);
+            } catch (...) {
+                std::cerr << "[config] Invalid ACTIVE_POLL_INTERVAL_SECONDS, using default\n";
+            }
+        } else if (key == "MAX_POLL_INTERVAL_SECONDS") {
+            try {
+                config.max_poll_interval_seconds = std::stoi(value);
+            } catch (...) {
+                std::cerr << "[config] Invalid MAX_POLL_INTERVAL_SECONDS, using default\n";
+            }
+        } else if (key == "POLL_CONCURRENCY") {
+            try {
+                config.poll_concurrency = std::max(1, std::stoi(value));
+            } catch (...) {
+                std::cerr << "[config] Invalid POLL_CONCURRENCY, using default\n";
+            }
+        } else if (key == "LEETIFY_REQUESTS_PER_MINUTE") {
+            try {
+                config.leetify_requests_per_minute = std::max(0, std::stoi(value));
+            } catch (...) {
+                std::cerr << "[config] Invalid LEETIFY_REQUESTS_PER_MINUTE, using default\n";
+            }
+        } else if (key == "LEETIFY_BURST") {
+            try {
+                config.leetify_burst = std::max(1, std::stoi(value));
+            } catch (...) {
+                std::cerr << "[config] Invalid LEETIFY_BURST, using default\n";
+            }
+        } else if (key == "LEETIFY_HEDGE_PERCENTILE") {
+            try {
+                config.leetify_hedge_percentile = std::clamp(std::stoi(value), 0, 99);
+            } catch (...) {
+                std::cerr << "[config] Invalid LEETIFY_HEDGE_PERCENTILE, using default\n";
+            }
+        } else if (key == "HTTP_COMPRESSION") {
+            config.http_compression = (value == "1" || value == "true" || value == "yes");
+        } else if (key == "FAST_JSON_PARSER") {
+            config.fast_json_parser = (value == "1" || value == "true" || value == "yes");
+        } else if (key == "EXTENDED_STATS") {
+            config.extended_stats = (value == "1" || value == "true" || value == "yes");
+        } else if (key == "MATCH_CACHE_DIR") {
+            config.match_cache_dir = value;
+        } else if (key == "MATCH_CACHE_MAX_MB") {
+            try {
+                config.match_cache_max_mb = std::max(0, std::stoi(value));
+            } catch (...) {
+                std::cerr << "[config] Invalid MATCH_CACHE_MAX_MB, using default\n";
+            }
+        } else if (key == "CATCHUP_MAX_MATCHES") {
+            try {
+                config.catchup_max_matches = std::max(1, std::stoi(value));
+            } catch (...) {
+                std::cerr << "[config] Invalid CATCHUP_MAX_MATCHES, using default\n";
+            }
         }
     }
     
@@ -75,8 +131,12 @@ void Config::parse_steam_ids(Config& config, const std::string& value) {
         id.erase(0, id.find_first_not_of(" \t"));
         id.erase(id.find_last_not_of(" \t") + 1);
         
-        if (!id.empty()) {
-            config.tracked_steam_ids.push_back(id);
+        if (id.empty()) continue;
+
+        if (auto steam_id = SteamId::parse(id)) {
+            config.tracked_steam_ids.push_back(*steam_id);
+        } else {
+            std::cerr << "[config] Ignoring invalid Steam ID in TRACKED_STEAM_IDS: " << id << "\n";
         }
     }
 }
@@ -1,6 +1,9 @@
 #include "discord_client.h"
 #define CPPHTTPLIB_OPENSSL_SUPPORT
 #include "httplib.h"
+#include "compression.h"
+#include "match_arena.h"
+#include "transfer_stats.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -8,6 +11,34 @@
 
 using json = nlohmann::json;
 
+namespace {
+
+// POST a JSON payload to the webhook, optionally accepting a compressed reply
+httplib::Result post_webhook(const std::string& base_url, const std::string& path,
+                             const std::string& body, bool compression) {
+    httplib::Client cli(base_url);
+    cli.set_connection_timeout(30, 0);
+    cli.set_read_timeout(30, 0);
+    cli.set_decompress(false);
+
+    httplib::Headers headers;
+    if (compression) {
+        headers.emplace("Accept-Encoding", "gzip, deflate");
+    }
+
+    auto res = cli.Post(path, headers, body, "application/json");
+    if (res) {
+        size_t wire_bytes = res->body.size();
+        if (!decode_content_encoding(res->body, res->get_header_value("Content-Encoding"))) {
+            res->body.clear();
+        }
+        TransferStats::global().record("discord webhook", wire_bytes, res->body.size());
+    }
+    return res;
+}
+
+}  // namespace
+
 DiscordClient::DiscordClient(const std::string& webhook_url) : webhook_url_(webhook_url) {
     webhook_path_ = extract_webhook_path(webhook_url);
 }
@@ -27,14 +58,10 @@ std::string DiscordClient::extract_webhook_path(const std::string& webhook_url)
 }
 
 bool DiscordClient::send_message(const std::string& message) {
-    httplib::Client cli(base_url_);
-    cli.set_connection_timeout(30, 0);
-    cli.set_read_timeout(30, 0);
-    
     json payload;
     payload["content"] = message;
     
-    auto res = cli.Post(webhook_path_, payload.dump(), "application/json");
+    auto res = post_webhook(base_url_, webhook_path_, payload.dump(), compression_);
     
     if (res && res->status >= 200 && res->status < 300) {
         return true;
@@ -49,21 +76,17 @@ bool DiscordClient::send_message(const std::string& message) {
     }
 }
 
-bool DiscordClient::send_match_report(const MatchData& match, const std::string& comment) {
-    httplib::Client cli(base_url_);
-    cli.set_connection_timeout(30, 0);
-    cli.set_read_timeout(30, 0);
-
+bool DiscordClient::send_match_report(const MatchData& match, const std::string& comment,
+                                      std::pmr::memory_resource* memory) {
     // Just send the AI comment as a simple message
     // Include map and score as a header, then the comment
-    std::ostringstream message;
-    message << "🎮 **" << match.map_name << "** (" << match.get_score_string() << ")\n\n";
-    message << comment;
+    ArenaOStream message(memory);
+    build_match_report(message, match, comment);
 
     json payload;
-    payload["content"] = message.str();
+    payload["content"] = message.view();
 
-    auto res = cli.Post(webhook_path_, payload.dump(), "application/json");
+    auto res = post_webhook(base_url_, webhook_path_, payload.dump(), compression_);
 
     if (res && res->status >= 200 && res->status < 300) {
         return true;
@@ -78,32 +101,42 @@ bool DiscordClient::send_match_report(const MatchData& match, const std::string&
     }
 }
 
-bool DiscordClient::send_multi_player_report(const MatchData& match,
-                                              const std::vector<PlayerStats>& tracked_players,
-                                              const std::map<std::string, std::string>& player_comments) {
-    httplib::Client cli(base_url_);
-    cli.set_connection_timeout(30, 0);
-    cli.set_read_timeout(30, 0);
+void DiscordClient::build_match_report(std::ostream& message, const MatchData& match,
+                                       const std::string& comment) {
+    message << "🎮 **" << match.map_name << "** (" << match.get_score_string() << ")\n\n";
+    message << comment;
+}
 
-    std::ostringstream message;
+void DiscordClient::build_multi_player_report(std::ostream& message, const MatchData& match,
+                                              const PlayerViews& tracked_players,
+                                              const std::map<SteamId, std::string>& player_comments) {
     message << "🎮 **" << match.map_name << "** (" << match.get_score_string() << ")\n";
 
-    for (const auto& player : tracked_players) {
-        message << "\n**" << player.name << "** ";
-        message << "(" << player.kills << "/" << player.deaths << "/" << player.assists;
-        message << ", ADR " << player.adr << ") ";
-        message << (player.won_match ? "WIN" : "LOSS") << "\n";
+    for (PlayerRef player : tracked_players) {
+        message << "\n**" << player.name() << "** ";
+        message << "(";
+        write_stats(message, player, kKdaStats | stat_bit(PlayerStat::adr));
+        message << ") ";
+        message << (player.won_match() ? "WIN" : "LOSS") << "\n";
 
-        auto it = player_comments.find(player.steam_id);
+        auto it = player_comments.find(player.steam_id());
         if (it != player_comments.end() && !it->second.empty()) {
             message << it->second << "\n";
         }
     }
+}
+
+bool DiscordClient::send_multi_player_report(const MatchData& match,
+                                              const PlayerViews& tracked_players,
+                                              const std::map<SteamId, std::string>& player_comments,
+                                              std::pmr::memory_resource* memory) {
+    ArenaOStream message(memory);
+    build_multi_player_report(message, match, tracked_players, player_comments);
 
     json payload;
-    payload["content"] = message.str();
+    payload["content"] = message.view();
 
-    auto res = cli.Post(webhook_path_, payload.dump(), "application/json");
+    auto res = post_webhook(base_url_, webhook_path_, payload.dump(), compression_);
 
     if (res && res->status >= 200 && res->status < 300) {
         return true;
@@ -121,10 +154,6 @@ bool DiscordClient::send_multi_player_report(const MatchData& match,
 bool DiscordClient::send_embed(const std::string& title, const std::string& description,
                                const std::vector<PlayerStats>& players, const std::string& footer_text) {
     // Keep this for backwards compatibility, but simplify it
-    httplib::Client cli(base_url_);
-    cli.set_connection_timeout(30, 0);
-    cli.set_read_timeout(30, 0);
-    
     std::ostringstream message;
     message << "**" << title << "**\n";
     message << description;
@@ -136,7 +165,7 @@ bool DiscordClient::send_embed(const std::string& title, const std::string& desc
     json payload;
     payload["content"] = message.str();
     
-    auto res = cli.Post(webhook_path_, payload.dump(), "application/json");
+    auto res = post_webhook(base_url_, webhook_path_, payload.dump(), compression_);
     
     return res && res->status >= 200 && res->status < 300;
 }
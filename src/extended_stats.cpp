@@ -0,0 +1,62 @@
+#include "extended_stats.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+
+void ExtendedStats::add(size_t key_offset, size_t key_length, size_t value_offset, size_t value_length) {
+    slices_.push_back({static_cast<uint32_t>(key_offset), static_cast<uint32_t>(key_length),
+                       static_cast<uint32_t>(value_offset), static_cast<uint32_t>(value_length)});
+}
+
+std::optional<std::string_view> ExtendedStats::raw(size_t player, std::string_view key) const {
+    if (!body_ || player >= player_begin_.size()) return std::nullopt;
+
+    size_t begin = player_begin_[player];
+    size_t end = player + 1 < player_begin_.size() ? player_begin_[player + 1] : slices_.size();
+    std::string_view body(*body_);
+    // Keys repeat in the payload; the last one wins, as with the roster stats
+    for (size_t i = end; i > begin; --i) {
+        const Slice& slice = slices_[i - 1];
+        if (body.substr(slice.key_offset, slice.key_length) == key) {
+            return body.substr(slice.value_offset, slice.value_length);
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<double> ExtendedStats::number(size_t player, std::string_view key) const {
+    std::optional<std::string_view> text = raw(player, key);
+    if (!text || text->empty() || !(text->front() == '-' || (text->front() >= '0' && text->front() <= '9'))) {
+        return std::nullopt;
+    }
+
+    // The parser only records well-formed JSON numbers, so strtod reads all of it
+    char token[64];
+    if (text->size() >= sizeof(token)) return std::nullopt;
+    std::memcpy(token, text->data(), text->size());
+    token[text->size()] = '\0';
+    return std::strtod(token, nullptr);
+}
+
+void write_extended_stats(std::ostream& out, const ExtendedStats& extended, size_t player,
+                          const StatStyle& style) {
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+#define X(key, label, format)                                                   \
+    if (std::optional<double> value = extended.number(player, key)) {          \
+        out << style.separator << label << style.label_separator;             \
+        if (format == StatFormat::Fixed2) {                                    \
+            out << std::fixed << std::setprecision(2) << *value;               \
+        } else {                                                               \
+            out << std::lround(*value);                                        \
+        }                                                                      \
+        if (format == StatFormat::Percent) out << "%";                         \
+    }
+    PLAYER_EXTENDED_FIELDS(X)
+#undef X
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,147 @@
+#include "json_scan.h"
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#define JSON_SCAN_SSE2 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+// AVX2 is compiled per function and only used after a runtime CPU check
+#if defined(JSON_SCAN_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define JSON_SCAN_AVX2 1
+#endif
+
+namespace {
+
+// ============================================================================
+// Scalar
+// ============================================================================
+
+inline bool ends_run(unsigned char c) {
+    return c == '"' || c == '\\' || c < 0x20 || c >= 0x80;
+}
+
+size_t scan_scalar_from(const char* data, size_t size, size_t i) {
+    while (i < size && !ends_run(static_cast<unsigned char>(data[i]))) ++i;
+    return i;
+}
+
+size_t scan_scalar(const char* data, size_t size) {
+    return scan_scalar_from(data, size, 0);
+}
+
+#ifdef JSON_SCAN_SSE2
+
+inline unsigned first_set_bit(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+// ============================================================================
+// SSE2 (baseline on x86-64)
+// ============================================================================
+
+size_t scan_sse2(const char* data, size_t size) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i space = _mm_set1_epi8(0x20);
+
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        // Compared as signed bytes, both control characters and bytes >= 0x80 are < 0x20
+        __m128i stop = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                 _mm_cmpeq_epi8(chunk, backslash)),
+                                    _mm_cmplt_epi8(chunk, space));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(stop));
+        if (mask != 0) return i + first_set_bit(mask);
+    }
+    return scan_scalar_from(data, size, i);
+}
+
+#endif
+
+#ifdef JSON_SCAN_AVX2
+
+// ============================================================================
+// AVX2
+// ============================================================================
+
+__attribute__((target("avx2")))
+size_t scan_avx2(const char* data, size_t size) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i space = _mm256_set1_epi8(0x20);
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i stop = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote),
+                                                       _mm256_cmpeq_epi8(chunk, backslash)),
+                                       _mm256_cmpgt_epi8(space, chunk));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(stop));
+        if (mask != 0) return i + first_set_bit(mask);
+    }
+    // Finish the last (< 32 byte) stretch 16 bytes at a time
+    return i + scan_sse2(data + i, size - i);
+}
+
+#endif
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+bool cpu_has_avx2() {
+#ifdef JSON_SCAN_AVX2
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+JsonScanBackend pick_backend() {
+#ifdef JSON_SCAN_AVX2
+    if (cpu_has_avx2()) return {scan_avx2, "avx2"};
+#endif
+#ifdef JSON_SCAN_SSE2
+    return {scan_sse2, "sse2"};
+#else
+    return {scan_scalar, "scalar"};
+#endif
+}
+
+const JsonScanBackend& backend() {
+    static const JsonScanBackend picked = pick_backend();
+    return picked;
+}
+
+}  // namespace
+
+size_t scan_string_run(const char* data, size_t size) {
+    return backend().scan(data, size);
+}
+
+const char* json_scan_backend() {
+    return backend().name;
+}
+
+std::vector<JsonScanBackend> json_scan_backends() {
+    std::vector<JsonScanBackend> backends{{scan_scalar, "scalar"}};
+#ifdef JSON_SCAN_SSE2
+    backends.push_back({scan_sse2, "sse2"});
+#endif
+#ifdef JSON_SCAN_AVX2
+    if (cpu_has_avx2()) backends.push_back({scan_avx2, "avx2"});
+#endif
+    return backends;
+}
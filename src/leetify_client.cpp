@@ -1,60 +1,471 @@
 #include "leetify_client.h"
 #define CPPHTTPLIB_OPENSSL_SUPPORT
 #include "httplib.h"
+#include "compression.h"
+#include "transfer_stats.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <iostream>
+#include <thread>
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
 
+namespace {
+
+constexpr int kMaxThrottledRetries = 5;
+
+// Longest pause a server header may put on the shared limiter; the pause
+// blocks every Leetify call and isn't interrupted on shutdown
+constexpr long kMaxServerPauseSeconds = 300;
+
+// Detail latencies kept for the hedge percentile, and how many are needed
+// before hedging starts
+constexpr size_t kHedgeLatencySamples = 128;
+constexpr size_t kMinHedgeSamples = 16;
+
+// FNV-1a: cheap fingerprint for detecting byte-identical responses
+uint64_t fnv1a_64(const std::string& data) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+long header_as_long(const httplib::Response& res, const char* name, long fallback) {
+    if (!res.has_header(name)) return fallback;
+    try {
+        return std::stol(res.get_header_value(name));
+    } catch (...) {
+        return fallback;
+    }
+}
+
+// A server-requested wait in seconds, capped at kMaxServerPauseSeconds
+long clamp_server_pause(long seconds, const char* header) {
+    if (seconds <= kMaxServerPauseSeconds) return seconds;
+    std::cerr << "[leetify] " << header << " of " << seconds << "s capped at "
+              << kMaxServerPauseSeconds << "s\n";
+    return kMaxServerPauseSeconds;
+}
+
+// Apply X-RateLimit-* / RateLimit-* quota headers to the limiter
+void observe_quota_headers(const httplib::Response& res, RateLimiter& limiter) {
+    long remaining = header_as_long(res, "X-RateLimit-Remaining",
+                                    header_as_long(res, "RateLimit-Remaining", -1));
+    long reset = header_as_long(res, "X-RateLimit-Reset",
+                                header_as_long(res, "RateLimit-Reset", -1));
+    if (remaining < 0 || reset < 0) return;
+
+    // Some APIs send an absolute epoch timestamp instead of a delta
+    if (reset > 1000000000L) {
+        long now = static_cast<long>(std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        reset = std::max(0L, reset - now);
+    }
+    reset = clamp_server_pause(reset, "Quota reset");
+    limiter.observe_quota(remaining, std::chrono::seconds(reset));
+}
+
+// Lets another thread abort an in-flight request (used to cancel hedge losers)
+struct CancelSlot {
+    std::mutex mutex;
+    httplib::Client* active = nullptr;
+    bool cancelled = false;
+
+    void cancel() {
+        std::lock_guard<std::mutex> lock(mutex);
+        cancelled = true;
+        if (active) active->stop();
+    }
+};
+
+struct GetOptions {
+    RateLimiter* limiter = nullptr;
+    bool compression = false;
+    std::string endpoint;
+    CancelSlot* cancel = nullptr;
+    // Called with the duration of each completed HTTP exchange (seconds)
+    std::function<void(double)> on_latency;
+};
+
+// GET against Leetify through the shared rate limiter. 429 responses pause the
+// limiter for Retry-After (or an exponential backoff) and the request is
+// queued again instead of failing. With compression on, the body is
+// requested gzip/deflate-encoded and decoded here.
+httplib::Result leetify_get(const std::string& base_url, const std::string& path,
+                            httplib::Headers headers, const GetOptions& options) {
+    RateLimiter* limiter = options.limiter;
+    if (options.compression) {
+        headers.emplace("Accept-Encoding", "gzip, deflate");
+    }
+
+    for (int attempt = 0;; ++attempt) {
+        if (limiter) limiter->acquire();
+
+        httplib::Client cli(base_url);
+        cli.set_connection_timeout(30, 0);
+        cli.set_read_timeout(30, 0);
+        // We decode ourselves so wire vs decoded size can be measured
+        cli.set_decompress(false);
+
+        if (options.cancel) {
+            std::lock_guard<std::mutex> lock(options.cancel->mutex);
+            if (options.cancel->cancelled) return httplib::Result();
+            options.cancel->active = &cli;
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        auto res = cli.Get(path, headers);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+
+        if (options.cancel) {
+            std::lock_guard<std::mutex> lock(options.cancel->mutex);
+            options.cancel->active = nullptr;
+            if (options.cancel->cancelled) return httplib::Result();
+        }
+        if (res && options.on_latency) {
+            options.on_latency(elapsed.count());
+        }
+
+        if (res) {
+            size_t wire_bytes = res->body.size();
+            if (!decode_content_encoding(res->body, res->get_header_value("Content-Encoding"))) {
+                std::cerr << "[leetify] Failed to decode " << res->get_header_value("Content-Encoding")
+                          << " response for " << path << "\n";
+                res->body.clear();
+            }
+            TransferStats::global().record(options.endpoint, wire_bytes, res->body.size());
+        }
+        if (!res || !limiter) return res;
+
+        observe_quota_headers(*res, *limiter);
+        if (res->status != 429 || attempt >= kMaxThrottledRetries) return res;
+
+        limiter->record_throttled();
+        long retry_after = header_as_long(*res, "Retry-After", -1);
+        if (retry_after >= 0) retry_after = clamp_server_pause(retry_after, "Retry-After");
+        auto delay = retry_after >= 0
+            ? std::chrono::milliseconds(retry_after * 1000)
+            : std::chrono::milliseconds(1000L << attempt);
+        std::cerr << "[leetify] Rate limited (429), retrying " << path << " in "
+                  << delay.count() / 1000.0 << "s\n";
+        limiter->pause_for(delay);
+    }
+}
+
+// Shared between the original request and its hedge; outlives whichever loses
+struct HedgeRace {
+    std::mutex mutex;
+    std::condition_variable cv;
+    httplib::Result result;
+    int winner = -1;  // Index of the request whose response is used
+    int finished = 0;
+    CancelSlot cancel[2];
+    std::shared_ptr<std::atomic<bool>> done[2] = {
+        std::make_shared<std::atomic<bool>>(false), std::make_shared<std::atomic<bool>>(false)};
+};
+
+void run_hedge_leg(std::shared_ptr<HedgeRace> race, int index, std::string base_url,
+                   std::string path, httplib::Headers headers, GetOptions options) {
+    options.cancel = &race->cancel[index];
+    auto res = leetify_get(base_url, path, std::move(headers), options);
+
+    std::lock_guard<std::mutex> lock(race->mutex);
+    ++race->finished;
+    if (res && race->winner < 0) {
+        race->winner = index;
+        race->result = std::move(res);
+    }
+    *race->done[index] = true;
+    race->cv.notify_all();
+}
+
+struct HedgeOutcome {
+    bool hedged = false;
+    bool hedge_won = false;
+    std::thread straggler;  // Cancelled loser, still unwinding
+    std::shared_ptr<std::atomic<bool>> straggler_done;
+};
+
+// Send the request; if it hasn't answered within `hedge_after`, send an
+// identical one. The first response wins and the other request is cancelled.
+httplib::Result hedged_get(const std::string& base_url, const std::string& path,
+                           const httplib::Headers& headers, const GetOptions& options,
+                           std::chrono::duration<double> hedge_after, HedgeOutcome& outcome) {
+    auto race = std::make_shared<HedgeRace>();
+    std::thread legs[2];
+    legs[0] = std::thread(run_hedge_leg, race, 0, base_url, path, headers, options);
+    int launched = 1;
+
+    std::unique_lock<std::mutex> lock(race->mutex);
+    if (!race->cv.wait_for(lock, hedge_after, [&] { return race->finished > 0; })) {
+        legs[1] = std::thread(run_hedge_leg, race, 1, base_url, path, headers, options);
+        launched = 2;
+        outcome.hedged = true;
+    }
+    race->cv.wait(lock, [&] { return race->winner >= 0 || race->finished == launched; });
+    int winner = race->winner;
+    httplib::Result result = std::move(race->result);
+    lock.unlock();
+
+    outcome.hedge_won = (winner == 1);
+    for (int i = 0; i < launched; ++i) {
+        if (i == winner || *race->done[i]) {
+            legs[i].join();
+            continue;
+        }
+        race->cancel[i].cancel();
+        outcome.straggler = std::move(legs[i]);
+        outcome.straggler_done = race->done[i];
+    }
+    return result;
+}
+
+}  // namespace
+
 LeetifyClient::LeetifyClient(const std::string& api_key) : api_key_(api_key) {}
 
-MatchData LeetifyClient::fetch_recent_match(const std::string& steam64_id) {
-    httplib::Client cli(base_url_);
-    cli.set_connection_timeout(30, 0);
-    cli.set_read_timeout(30, 0);
+LeetifyClient::~LeetifyClient() {
+    std::lock_guard<std::mutex> lock(stragglers_mutex_);
+    for (auto& straggler : stragglers_) {
+        straggler.thread.join();
+    }
+}
 
-    std::string path = "/v3/profile/matches?steam64_id=" + steam64_id;
+std::vector<MatchListEntry> LeetifyClient::fetch_recent_matches(SteamId steam64_id,
+                                                                const MatchListStop& stop_after) {
+    return fetch_match_list(steam64_id, false, stop_after).entries;
+}
+
+MatchListResult LeetifyClient::poll_match_list(SteamId steam64_id,
+                                               const MatchListStop& stop_after) {
+    return fetch_match_list(steam64_id, true, stop_after);
+}
+
+void LeetifyClient::forget_list_fingerprint(SteamId steam64_id) {
+    std::lock_guard<std::mutex> lock(fingerprints_mutex_);
+    fingerprints_.erase(steam64_id);
+}
+
+MatchListResult LeetifyClient::fetch_match_list(SteamId steam64_id, bool use_fingerprint,
+                                                const MatchListStop& stop_after) {
+    MatchListResult result;
+    std::string path = "/v3/profile/matches?steam64_id=" + steam64_id.to_string();
 
     httplib::Headers headers = {{"x-api-key", api_key_}};
 
-    auto res = cli.Get(path, headers);
+    ListFingerprint previous;
+    bool has_previous = false;
+    if (use_fingerprint) {
+        ++list_polls_;
+        std::lock_guard<std::mutex> lock(fingerprints_mutex_);
+        auto it = fingerprints_.find(steam64_id);
+        if (it != fingerprints_.end()) {
+            previous = it->second;
+            has_previous = true;
+            if (!previous.etag.empty()) {
+                headers.emplace("If-None-Match", previous.etag);
+            }
+        }
+    }
+
+    GetOptions options;
+    options.limiter = rate_limiter_.get();
+    options.compression = compression_;
+    options.endpoint = "leetify /v3/profile/matches";
+    auto res = leetify_get(base_url_, path, headers, options);
     if (!res) {
         std::cerr << "[leetify] Connection failed\n";
-        return {};
+        return result;
+    }
+
+    if (res->status == 304 && has_previous) {
+        ++unchanged_list_polls_;
+        result.status = MatchListResult::Status::Unchanged;
+        result.newest_id = previous.newest_id;
+        return result;
     }
+
     if (res->status != 200) {
         std::cerr << "[leetify] Error fetching matches list. Status " << res->status << "\n";
         std::cerr << "[leetify] Response: " << res->body.substr(0, 200) << "\n";
-        return {};
+        return result;
     }
 
-    std::string recent_match_id = parse_most_recent_match_id(res->body);
+    // Byte-identical body: nothing to parse
+    uint64_t body_hash = fnv1a_64(res->body);
+    if (has_previous && previous.body_hash == body_hash) {
+        ++unchanged_list_polls_;
+        result.status = MatchListResult::Status::Unchanged;
+        result.newest_id = previous.newest_id;
+        return result;
+    }
 
-    if (recent_match_id.empty()) {
+    result.entries = parse_match_list(res->body, stop_after);
+
+    if (result.entries.empty()) {
         std::cerr << "[leetify] No matches found\n";
-        return {};
+        return result;
     }
 
-    std::cout << "[leetify] Most recent match ID: " << recent_match_id << "\n";
+    result.status = MatchListResult::Status::Ok;
+    result.newest_id = result.entries.front().id;
+    std::cout << "[leetify] Most recent match ID: " << result.newest_id << "\n";
+
+    if (use_fingerprint) {
+        ListFingerprint fingerprint;
+        fingerprint.etag = res->get_header_value("ETag");
+        fingerprint.body_hash = body_hash;
+        fingerprint.newest_id = result.newest_id;
+        std::lock_guard<std::mutex> lock(fingerprints_mutex_);
+        fingerprints_[steam64_id] = std::move(fingerprint);
+    }
+    return result;
+}
+
+std::string LeetifyClient::fetch_recent_match_id(SteamId steam64_id) {
+    std::vector<MatchListEntry> entries =
+        fetch_recent_matches(steam64_id, [](const MatchListEntry&) { return true; });
+    return entries.empty() ? std::string() : entries.front().id;
+}
+
+MatchSnapshot LeetifyClient::fetch_recent_match(SteamId steam64_id) {
+    std::string recent_match_id = fetch_recent_match_id(steam64_id);
+    if (recent_match_id.empty()) {
+        return nullptr;
+    }
     return fetch_match_details(recent_match_id);
 }
 
-MatchData LeetifyClient::fetch_match_details(const std::string& match_id) {
+MatchSnapshot LeetifyClient::fetch_match_details(const std::string& match_id) {
+    std::promise<MatchSnapshot> promise;
+    std::shared_future<MatchSnapshot> shared;
+    {
+        std::lock_guard<std::mutex> lock(fetches_mutex_);
+        auto it = fetches_.find(match_id);
+        if (it != fetches_.end()) {
+            shared = it->second;
+        } else {
+            fetches_[match_id] = promise.get_future().share();
+        }
+    }
+
+    // Another caller already owns this fetch - wait for its result
+    if (shared.valid()) {
+        ++coalesced_fetches_;
+        std::cout << "[leetify] Joining in-flight fetch for match " << match_id << "\n";
+        return shared.get();
+    }
+
+    MatchSnapshot match;
+    try {
+        MatchData parsed = download_match_details(match_id);
+        if (parsed.is_valid()) {
+            match = std::make_shared<const MatchData>(std::move(parsed));
+        }
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+        std::lock_guard<std::mutex> lock(fetches_mutex_);
+        fetches_.erase(match_id);
+        throw;
+    }
+    promise.set_value(match);
+
+    // Don't keep failures around, so the next caller retries
+    if (!match) {
+        std::lock_guard<std::mutex> lock(fetches_mutex_);
+        fetches_.erase(match_id);
+    }
+    return match;
+}
+
+void LeetifyClient::clear_completed_fetches() {
+    std::lock_guard<std::mutex> lock(fetches_mutex_);
+    for (auto it = fetches_.begin(); it != fetches_.end();) {
+        if (it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            it = fetches_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+MatchData LeetifyClient::parse_details(std::shared_ptr<const std::string> body, const std::string& match_id) {
+    if (fast_json_ || extended_stats_) {
+        std::optional<MatchData> match = extended_stats_ ? parse_match_details_extended(body, match_id)
+                                                         : parse_match_details_fast(*body, match_id);
+        if (match) {
+            ++fast_parses_;
+            return std::move(*match);
+        }
+        ++fast_parse_fallbacks_;
+        std::cout << "[leetify] Match " << match_id << " doesn't fit the fast parser, using nlohmann"
+                  << (extended_stats_ ? " (no extended stats)" : "") << "\n";
+    }
+    return parse_match_details_from_json(*body, match_id);
+}
+
+MatchData LeetifyClient::download_match_details(const std::string& match_id) {
     MatchData match;
-    
-    httplib::Client cli(base_url_);
-    cli.set_connection_timeout(30, 0);
-    cli.set_read_timeout(30, 0);
+
+    // Finished matches never change, so a cached payload is as good as a fresh one
+    if (match_cache_) {
+        if (auto body = match_cache_->get(match_id)) {
+            match = parse_details(std::make_shared<const std::string>(std::move(*body)), match_id);
+            if (match.is_valid()) {
+                std::cout << "[leetify] Loaded match " << match_id << " from cache ("
+                          << match.players.size() << " players)\n";
+                return match;
+            }
+            std::cerr << "[leetify] Cached match " << match_id << " doesn't parse, fetching it again\n";
+            match_cache_->evict(match_id);
+        }
+    }
     
     std::string path = "/v2/matches/" + match_id;
     
     httplib::Headers headers = {{"x-api-key", api_key_}};
     
-    auto res = cli.Get(path, headers);
+    GetOptions options;
+    options.limiter = rate_limiter_.get();
+    options.compression = compression_;
+    options.endpoint = "leetify /v2/matches";
+    options.on_latency = [this](double seconds) { record_detail_latency(seconds); };
+
+    httplib::Result res;
+    ++detail_requests_sent_;
+    double hedge_after = hedge_delay_seconds();
+    if (hedge_after > 0.0) {
+        HedgeOutcome outcome;
+        res = hedged_get(base_url_, path, headers, options,
+                         std::chrono::duration<double>(hedge_after), outcome);
+        if (outcome.hedged) {
+            ++hedges_issued_;
+            ++detail_requests_sent_;
+            std::cout << "[leetify] No answer for match " << match_id << " after "
+                      << hedge_after << "s, sent a hedge request ("
+                      << (outcome.hedge_won ? "hedge won" : "original won") << ")\n";
+        }
+        if (outcome.hedge_won) ++hedges_won_;
+        if (outcome.straggler.joinable()) {
+            park_straggler({std::move(outcome.straggler), std::move(outcome.straggler_done)});
+        }
+    } else {
+        res = leetify_get(base_url_, path, headers, options);
+    }
     
     if (res && res->status == 200) {
-        match = parse_match_details_from_json(res->body, match_id);
+        auto body = std::make_shared<const std::string>(std::move(res->body));
+        match = parse_details(body, match_id);
         std::cout << "[leetify] Parsed " << match.players.size() << " players\n";
+        if (match_cache_ && match.is_valid()) {
+            match_cache_->put(match_id, *body);
+        }
     } else {
         std::cerr << "[leetify] Error fetching match details: ";
         if (res) {
@@ -66,6 +477,44 @@ MatchData LeetifyClient::fetch_match_details(const std::string& match_id) {
     return match;
 }
 
+void LeetifyClient::record_detail_latency(double seconds) {
+    std::lock_guard<std::mutex> lock(latencies_mutex_);
+    if (detail_latencies_.size() < kHedgeLatencySamples) {
+        detail_latencies_.push_back(seconds);
+    } else {
+        detail_latencies_[next_latency_slot_] = seconds;
+        next_latency_slot_ = (next_latency_slot_ + 1) % kHedgeLatencySamples;
+    }
+}
+
+double LeetifyClient::hedge_delay_seconds() {
+    if (hedge_percentile_ <= 0) return 0.0;
+
+    std::vector<double> samples;
+    {
+        std::lock_guard<std::mutex> lock(latencies_mutex_);
+        if (detail_latencies_.size() < kMinHedgeSamples) return 0.0;
+        samples = detail_latencies_;
+    }
+    auto nth = samples.begin() + (samples.size() - 1) * hedge_percentile_ / 100;
+    std::nth_element(samples.begin(), nth, samples.end());
+    return *nth;
+}
+
+void LeetifyClient::park_straggler(Straggler straggler) {
+    std::lock_guard<std::mutex> lock(stragglers_mutex_);
+    // Reap losers that have finished unwinding since the last hedge
+    for (auto it = stragglers_.begin(); it != stragglers_.end();) {
+        if (*it->done) {
+            it->thread.join();
+            it = stragglers_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    stragglers_.push_back(std::move(straggler));
+}
+
 bool LeetifyClient::is_valid() const {
     return !api_key_.empty();
 }
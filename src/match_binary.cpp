@@ -0,0 +1,396 @@
+#include "match_binary.h"
+#include "byte_order.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char kMagic[8] = {'C', 'S', 'H', 'M', 'A', 'T', 'C', 'H'};
+
+// Header field offsets
+constexpr size_t kVersionAt = 8;         // u16
+constexpr size_t kHeaderSizeAt = 10;     // u16
+constexpr size_t kTotalSizeAt = 12;      // u32
+constexpr size_t kPlayerCountAt = 16;    // u32
+constexpr size_t kTeamCountAt = 20;      // u32
+constexpr size_t kColumnDirAt = 24;      // u32 offset
+constexpr size_t kColumnCountAt = 28;    // u32
+constexpr size_t kSteamIdsAt = 32;       // u32 offset
+constexpr size_t kNameRefsAt = 36;       // u32 offset
+constexpr size_t kTeamScoresAt = 40;     // u32 offset
+constexpr size_t kStringsAt = 44;        // u32 offset
+constexpr size_t kStringsSizeAt = 48;    // u32
+constexpr size_t kMatchIdRefAt = 52;     // string ref
+constexpr size_t kMapNameRefAt = 60;     // string ref
+constexpr size_t kFinishedAtRefAt = 68;  // string ref
+constexpr size_t kHeaderSize = 80;
+
+constexpr size_t kStringRefSize = 8;   // u32 offset into the string table, u32 length
+constexpr size_t kColumnDirEntry = 8;  // u32 offset, u32 element size
+constexpr size_t kTeamScoreSize = 8;   // i32 team_number, i32 score
+
+constexpr size_t kColumnCount = static_cast<size_t>(PlayerStat::Count);
+
+size_t align8(size_t offset) { return (offset + 7) & ~size_t(7); }
+
+// Appends strings and hands back {offset, length} refs
+class StringTable {
+public:
+    std::pair<uint32_t, uint32_t> add(std::string_view text) {
+        uint32_t offset = static_cast<uint32_t>(bytes_.size());
+        bytes_.append(text);
+        return {offset, static_cast<uint32_t>(text.size())};
+    }
+
+    const std::string& bytes() const { return bytes_; }
+
+private:
+    std::string bytes_;
+};
+
+void store_ref(unsigned char* out, std::pair<uint32_t, uint32_t> ref) {
+    store_le(out, ref.first);
+    store_le(out + 4, ref.second);
+}
+
+bool fail(std::string* error, const char* reason) {
+    if (error) *error = reason;
+    return false;
+}
+
+}  // namespace
+
+// ============================================================================
+// Encoding
+// ============================================================================
+
+std::string encode_match(const MatchData& match) {
+    const Roster& players = match.players;
+    const size_t player_count = players.size();
+    const size_t team_count = match.team_scores.size();
+
+    StringTable strings;
+    auto match_id_ref = strings.add(match.match_id);
+    auto map_name_ref = strings.add(match.map_name);
+    auto finished_at_ref = strings.add(match.game_finished_at);
+    std::vector<std::pair<uint32_t, uint32_t>> name_refs;
+    name_refs.reserve(player_count);
+    const std::string* const* names = players.name_column();
+    for (size_t i = 0; i < player_count; ++i) {
+        name_refs.push_back(strings.add(*names[i]));
+    }
+
+    // Lay out the sections
+    size_t offset = kHeaderSize;
+    const size_t column_dir = offset;
+    offset = align8(offset + kColumnCount * kColumnDirEntry);
+    const size_t steam_ids = offset;
+    offset = align8(offset + player_count * sizeof(uint64_t));
+    size_t column_offsets[kColumnCount];
+    size_t column_sizes[kColumnCount];
+#define X(member, type, ...)                                                         \
+    column_offsets[static_cast<size_t>(PlayerStat::member)] = offset;                \
+    column_sizes[static_cast<size_t>(PlayerStat::member)] = sizeof(column_t<type>);  \
+    offset = align8(offset + player_count * sizeof(column_t<type>));
+    PLAYER_STAT_FIELDS(X)
+#undef X
+    const size_t name_refs_at = offset;
+    offset = align8(offset + player_count * kStringRefSize);
+    const size_t team_scores = offset;
+    offset = align8(offset + team_count * kTeamScoreSize);
+    const size_t strings_at = offset;
+    const size_t total = align8(offset + strings.bytes().size());
+
+    std::string out(total, '\0');
+    auto* base = reinterpret_cast<unsigned char*>(&out[0]);
+
+    std::copy(kMagic, kMagic + sizeof(kMagic), base);
+    store_le(base + kVersionAt, kMatchFormatVersion);
+    store_le(base + kHeaderSizeAt, static_cast<uint16_t>(kHeaderSize));
+    store_le(base + kTotalSizeAt, static_cast<uint32_t>(total));
+    store_le(base + kPlayerCountAt, static_cast<uint32_t>(player_count));
+    store_le(base + kTeamCountAt, static_cast<uint32_t>(team_count));
+    store_le(base + kColumnDirAt, static_cast<uint32_t>(column_dir));
+    store_le(base + kColumnCountAt, static_cast<uint32_t>(kColumnCount));
+    store_le(base + kSteamIdsAt, static_cast<uint32_t>(steam_ids));
+    store_le(base + kNameRefsAt, static_cast<uint32_t>(name_refs_at));
+    store_le(base + kTeamScoresAt, static_cast<uint32_t>(team_scores));
+    store_le(base + kStringsAt, static_cast<uint32_t>(strings_at));
+    store_le(base + kStringsSizeAt, static_cast<uint32_t>(strings.bytes().size()));
+    store_ref(base + kMatchIdRefAt, match_id_ref);
+    store_ref(base + kMapNameRefAt, map_name_ref);
+    store_ref(base + kFinishedAtRefAt, finished_at_ref);
+
+    for (size_t c = 0; c < kColumnCount; ++c) {
+        store_le(base + column_dir + c * kColumnDirEntry, static_cast<uint32_t>(column_offsets[c]));
+        store_le(base + column_dir + c * kColumnDirEntry + 4, static_cast<uint32_t>(column_sizes[c]));
+    }
+
+    const uint64_t* ids = players.steam_id_column();
+    for (size_t i = 0; i < player_count; ++i) {
+        store_le(base + steam_ids + i * sizeof(uint64_t), ids[i]);
+    }
+
+#define X(member, type, ...)                                                          \
+    {                                                                                 \
+        const auto* column = players.member##_column();                               \
+        unsigned char* at = base + column_offsets[static_cast<size_t>(PlayerStat::member)]; \
+        for (size_t i = 0; i < player_count; ++i) {                                   \
+            store_le(at + i * sizeof(column_t<type>), column[i]);                     \
+        }                                                                             \
+    }
+    PLAYER_STAT_FIELDS(X)
+#undef X
+
+    for (size_t i = 0; i < player_count; ++i) {
+        store_ref(base + name_refs_at + i * kStringRefSize, name_refs[i]);
+    }
+    for (size_t i = 0; i < team_count; ++i) {
+        store_le(base + team_scores + i * kTeamScoreSize, static_cast<int32_t>(match.team_scores[i].team_number));
+        store_le(base + team_scores + i * kTeamScoreSize + 4, static_cast<int32_t>(match.team_scores[i].score));
+    }
+    std::copy(strings.bytes().begin(), strings.bytes().end(), base + strings_at);
+
+    return out;
+}
+
+// ============================================================================
+// In-place reading
+// ============================================================================
+
+std::optional<MatchView> MatchView::open(const void* data, size_t size, std::string* error) {
+    const auto* base = static_cast<const unsigned char*>(data);
+    if (!base || size < kHeaderSize) {
+        fail(error, "buffer too small for a header");
+        return std::nullopt;
+    }
+    if (!std::equal(kMagic, kMagic + sizeof(kMagic), reinterpret_cast<const char*>(base))) {
+        fail(error, "bad magic");
+        return std::nullopt;
+    }
+
+    MatchView view;
+    view.data_ = base;
+    view.version_ = load_le<uint16_t>(base + kVersionAt);
+    if (view.version_ != kMatchFormatVersion) {
+        fail(error, "unsupported format version");
+        return std::nullopt;
+    }
+
+    const size_t header_size = load_le<uint16_t>(base + kHeaderSizeAt);
+    const size_t total = load_le<uint32_t>(base + kTotalSizeAt);
+    if (header_size < kHeaderSize || total > size || header_size > total) {
+        fail(error, "bad header or truncated buffer");
+        return std::nullopt;
+    }
+
+    view.player_count_ = load_le<uint32_t>(base + kPlayerCountAt);
+    view.team_count_ = load_le<uint32_t>(base + kTeamCountAt);
+    view.column_dir_ = load_le<uint32_t>(base + kColumnDirAt);
+    view.column_count_ = load_le<uint32_t>(base + kColumnCountAt);
+    view.steam_ids_ = load_le<uint32_t>(base + kSteamIdsAt);
+    view.name_refs_ = load_le<uint32_t>(base + kNameRefsAt);
+    view.team_scores_ = load_le<uint32_t>(base + kTeamScoresAt);
+    view.strings_ = load_le<uint32_t>(base + kStringsAt);
+    const size_t strings_size = load_le<uint32_t>(base + kStringsSizeAt);
+    view.match_id_ref_ = kMatchIdRefAt;
+    view.map_name_ref_ = kMapNameRefAt;
+    view.finished_at_ref_ = kFinishedAtRefAt;
+
+    // Every section has to fit; 64-bit math so huge counts can't wrap
+    auto fits = [total](uint64_t offset, uint64_t count, uint64_t element) {
+        return offset >= kHeaderSize && offset <= total && count * element <= total - offset;
+    };
+    const uint64_t players = view.player_count_;
+    if (!fits(view.column_dir_, view.column_count_, kColumnDirEntry) ||
+        !fits(view.steam_ids_, players, sizeof(uint64_t)) ||
+        !fits(view.name_refs_, players, kStringRefSize) ||
+        !fits(view.team_scores_, view.team_count_, kTeamScoreSize) ||
+        !fits(view.strings_, strings_size, 1)) {
+        fail(error, "section out of bounds");
+        return std::nullopt;
+    }
+
+    // Columns this build knows about must have the element size it expects
+    for (size_t c = 0; c < view.column_count_ && c < kColumnCount; ++c) {
+        const unsigned char* entry = base + view.column_dir_ + c * kColumnDirEntry;
+        const uint32_t offset = load_le<uint32_t>(entry);
+        const uint32_t element = load_le<uint32_t>(entry + 4);
+        size_t expected = 0;
+        switch (static_cast<PlayerStat>(c)) {
+#define X(member, type, ...) \
+            case PlayerStat::member: expected = sizeof(column_t<type>); break;
+            PLAYER_STAT_FIELDS(X)
+#undef X
+            case PlayerStat::Count: break;
+        }
+        if (element != expected || !fits(offset, players, element)) {
+            fail(error, "stat column doesn't match this build's field table");
+            return std::nullopt;
+        }
+    }
+
+    auto ref_ok = [&](size_t ref_at) {
+        const uint64_t offset = load_le<uint32_t>(base + ref_at);
+        const uint64_t length = load_le<uint32_t>(base + ref_at + 4);
+        return offset <= strings_size && length <= strings_size - offset;
+    };
+    if (!ref_ok(kMatchIdRefAt) || !ref_ok(kMapNameRefAt) || !ref_ok(kFinishedAtRefAt)) {
+        fail(error, "string ref out of bounds");
+        return std::nullopt;
+    }
+    for (size_t i = 0; i < players; ++i) {
+        if (!ref_ok(view.name_refs_ + i * kStringRefSize)) {
+            fail(error, "name ref out of bounds");
+            return std::nullopt;
+        }
+    }
+
+    return view;
+}
+
+std::string_view MatchView::string_at(uint32_t ref_offset) const {
+    const uint32_t offset = load_le<uint32_t>(data_ + ref_offset);
+    const uint32_t length = load_le<uint32_t>(data_ + ref_offset + 4);
+    return std::string_view(reinterpret_cast<const char*>(data_ + strings_ + offset), length);
+}
+
+template <typename T>
+T MatchView::column_value(PlayerStat stat, size_t player, T fallback) const {
+    const size_t column = static_cast<size_t>(stat);
+    if (column >= column_count_) return fallback;  // Written before this stat existed
+    const uint32_t offset = load_le<uint32_t>(data_ + column_dir_ + column * kColumnDirEntry);
+    return static_cast<T>(load_le<column_t<T>>(data_ + offset + player * sizeof(column_t<T>)));
+}
+
+SteamId MatchView::steam_id(size_t player) const {
+    return SteamId(load_le<uint64_t>(data_ + steam_ids_ + player * sizeof(uint64_t)));
+}
+
+std::string_view MatchView::name(size_t player) const {
+    return string_at(static_cast<uint32_t>(name_refs_ + player * kStringRefSize));
+}
+
+#define X(member, type, def, ...)                                \
+    type MatchView::member(size_t player) const {                \
+        return column_value<type>(PlayerStat::member, player, def); \
+    }
+PLAYER_STAT_FIELDS(X)
+#undef X
+
+TeamScore MatchView::team_score(size_t team) const {
+    const unsigned char* at = data_ + team_scores_ + team * kTeamScoreSize;
+    TeamScore score;
+    score.team_number = load_le<int32_t>(at);
+    score.score = load_le<int32_t>(at + 4);
+    return score;
+}
+
+MatchData MatchView::to_match_data() const {
+    MatchData match;
+    match.match_id = std::string(match_id());
+    match.map_name = std::string(map_name());
+    match.game_finished_at = std::string(game_finished_at());
+
+    match.players.reserve(player_count_);
+    for (size_t i = 0; i < player_count_; ++i) {
+        PlayerStats player;
+        player.steam_id = steam_id(i);
+        player.name = std::string(name(i));
+#define X(member, ...) player.member = member(i);
+        PLAYER_STAT_FIELDS(X)
+#undef X
+        match.players.push_back(player);
+    }
+
+    match.team_scores.reserve(team_count_);
+    for (size_t i = 0; i < team_count_; ++i) {
+        match.team_scores.push_back(team_score(i));
+    }
+    return match;
+}
+
+// ============================================================================
+// Files
+// ============================================================================
+
+bool write_match_file(const std::string& path, const MatchData& match) {
+    std::string encoded = encode_match(match);
+    std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "[match-binary] Failed to open file for writing: " << tmp_path << "\n";
+            return false;
+        }
+        file.write(encoded.data(), static_cast<std::streamsize>(encoded.size()));
+        if (!file.good()) return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        std::cerr << "[match-binary] Failed to save " << path << ": " << ec.message() << "\n";
+        return false;
+    }
+    return true;
+}
+
+MappedMatchFile::~MappedMatchFile() {
+    close();
+}
+
+void MappedMatchFile::close() {
+    view_.reset();
+#ifndef _WIN32
+    if (mapping_) munmap(const_cast<void*>(mapping_), size_);
+#endif
+    mapping_ = nullptr;
+    size_ = 0;
+    buffer_.clear();
+}
+
+bool MappedMatchFile::open(const std::string& path, std::string* error) {
+    close();
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return fail(error, "cannot open file");
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return fail(error, "cannot stat file");
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    void* mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        size_ = 0;
+        return fail(error, "mmap failed");
+    }
+    mapping_ = mapped;
+    view_ = MatchView::open(mapping_, size_, error);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return fail(error, "cannot open file");
+    buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    view_ = MatchView::open(buffer_.data(), buffer_.size(), error);
+#endif
+
+    if (!view_) {
+        close();
+        return false;
+    }
+    return true;
+}
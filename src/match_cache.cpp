@@ -0,0 +1,207 @@
+#include "match_cache.h"
+#include "compression.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char* kCacheSuffix = ".json.gz";
+
+}  // namespace
+
+MatchCache::MatchCache(const std::string& directory, size_t max_bytes)
+    : directory_(directory), max_bytes_(max_bytes) {}
+
+void MatchCache::load() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    entries_.clear();
+    total_bytes_ = 0;
+
+    std::error_code ec;
+    fs::create_directories(directory_, ec);
+    if (ec) {
+        std::cerr << "[cache] Failed to create " << directory_ << ": " << ec.message() << "\n";
+        return;
+    }
+
+    // Oldest mtime first, so pushing to the front leaves the newest at the front
+    std::vector<std::pair<fs::file_time_type, fs::directory_entry>> files;
+    for (const auto& file : fs::directory_iterator(directory_, ec)) {
+        std::string name = file.path().filename().string();
+        std::string suffix = kCacheSuffix;
+        if (!file.is_regular_file() || name.size() <= suffix.size() ||
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+            continue;
+        }
+        files.emplace_back(file.last_write_time(), file);
+    }
+    std::sort(files.begin(), files.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (const auto& [mtime, file] : files) {
+        std::string name = file.path().filename().string();
+        std::string match_id = name.substr(0, name.size() - std::string(kCacheSuffix).size());
+        lru_.push_front(match_id);
+        Entry entry;
+        entry.bytes = static_cast<size_t>(file.file_size());
+        entry.lru_pos = lru_.begin();
+        entries_[match_id] = entry;
+        total_bytes_ += entry.bytes;
+    }
+    evict_if_needed();
+
+    std::cout << "[cache] Loaded " << entries_.size() << " cached match(es), "
+              << total_bytes_ / 1024 << " KiB\n";
+}
+
+std::optional<std::string> MatchCache::get(const std::string& match_id) {
+    std::string compressed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(match_id);
+        if (it == entries_.end()) {
+            ++misses_;
+            return std::nullopt;
+        }
+
+        std::ifstream file(path_for(match_id), std::ios::binary);
+        if (file.is_open()) {
+            compressed.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+
+        if (compressed.empty()) {
+            // File vanished or unreadable - drop the entry
+            remove_locked(match_id);
+            ++misses_;
+            return std::nullopt;
+        }
+
+        touch(match_id, it->second);
+    }
+
+    auto body = gzip_decompress(compressed);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!body) {
+        // Drop it, so the next download can store a good copy
+        std::cerr << "[cache] Corrupt cache file for match " << match_id << ", dropping it\n";
+        remove_locked(match_id);
+        ++misses_;
+        return std::nullopt;
+    }
+    ++hits_;
+    return body;
+}
+
+void MatchCache::evict(const std::string& match_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    remove_locked(match_id);
+}
+
+void MatchCache::put(const std::string& match_id, const std::string& body) {
+    if (max_bytes_ == 0 || !is_safe_id(match_id)) return;
+
+    std::string compressed = gzip_compress(body);
+    if (compressed.empty() || compressed.size() > max_bytes_) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Write to a temp file and rename, so readers never see a partial file
+    fs::path path = path_for(match_id);
+    fs::path tmp_path = path;
+    tmp_path += ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        file.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+        if (!file.good()) {
+            std::cerr << "[cache] Failed to write " << tmp_path << "\n";
+            return;
+        }
+    }
+    std::error_code ec;
+    fs::rename(tmp_path, path, ec);
+    if (ec) {
+        std::cerr << "[cache] Failed to store match " << match_id << ": " << ec.message() << "\n";
+        fs::remove(tmp_path, ec);
+        return;
+    }
+
+    auto existing = entries_.find(match_id);
+    if (existing != entries_.end()) {
+        total_bytes_ -= existing->second.bytes;
+        lru_.erase(existing->second.lru_pos);
+        entries_.erase(existing);
+    }
+    lru_.push_front(match_id);
+    Entry entry;
+    entry.bytes = compressed.size();
+    entry.lru_pos = lru_.begin();
+    entries_[match_id] = entry;
+    total_bytes_ += entry.bytes;
+    evict_if_needed();
+}
+
+size_t MatchCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+size_t MatchCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+void MatchCache::log_summary() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::cout << "[cache] " << entries_.size() << " match(es), " << total_bytes_ / 1024 << " KiB, "
+              << hits_ << " hit(s), " << misses_ << " miss(es)\n";
+}
+
+fs::path MatchCache::path_for(const std::string& match_id) const {
+    return directory_ / (match_id + kCacheSuffix);
+}
+
+bool MatchCache::is_safe_id(const std::string& match_id) {
+    if (match_id.empty() || match_id.size() > 64) return false;
+    return std::all_of(match_id.begin(), match_id.end(), [](char c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '-';
+    });
+}
+
+void MatchCache::touch(const std::string& match_id, Entry& entry) {
+    lru_.splice(lru_.begin(), lru_, entry.lru_pos);
+    entry.lru_pos = lru_.begin();
+
+    std::error_code ec;
+    fs::last_write_time(path_for(match_id), fs::file_time_type::clock::now(), ec);
+}
+
+void MatchCache::remove_locked(const std::string& match_id) {
+    auto it = entries_.find(match_id);
+    if (it == entries_.end()) return;
+    total_bytes_ -= it->second.bytes;
+    lru_.erase(it->second.lru_pos);
+    entries_.erase(it);
+
+    std::error_code ec;
+    fs::remove(path_for(match_id), ec);
+}
+
+void MatchCache::evict_if_needed() {
+    while (total_bytes_ > max_bytes_ && !lru_.empty()) {
+        const std::string& victim = lru_.back();
+        auto it = entries_.find(victim);
+        if (it != entries_.end()) {
+            total_bytes_ -= it->second.bytes;
+            entries_.erase(it);
+        }
+        std::error_code ec;
+        fs::remove(path_for(victim), ec);
+        lru_.pop_back();
+    }
+}
@@ -1,10 +1,18 @@
 #include "match_data.h"
 #include <algorithm>
+#include <charconv>
 #include <iomanip>
 #include <sstream>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <nlohmann/json.hpp>
+#include "json_scan.h"
 
 using json = nlohmann::json;
 
@@ -12,34 +20,29 @@ using json = nlohmann::json;
 // MatchData method implementations
 // ============================================================================
 
-std::optional<PlayerStats> MatchData::get_player_stats(const std::string& steam_id) const {
-    for (const auto& player : players) {
-        if (player.steam_id == steam_id) {
-            return player;
-        }
+std::optional<PlayerRef> MatchData::get_player_stats(SteamId steam_id) const {
+    if (auto index = players.find(steam_id)) {
+        return players[*index];
     }
     return std::nullopt;
 }
 
-bool MatchData::has_tracked_players(const std::vector<std::string>& tracked_ids) const {
-    for (const auto& player : players) {
-        for (const auto& tracked_id : tracked_ids) {
-            if (player.steam_id == tracked_id) {
-                return true;
-            }
+bool MatchData::has_tracked_players(const TrackedIndex& tracked) const {
+    const uint64_t* ids = players.steam_id_column();
+    for (size_t i = 0; i < players.size(); ++i) {
+        if (tracked.contains(SteamId(ids[i]))) {
+            return true;
         }
     }
     return false;
 }
 
-std::vector<PlayerStats> MatchData::get_tracked_players(const std::vector<std::string>& tracked_ids) const {
-    std::vector<PlayerStats> result;
-    for (const auto& player : players) {
-        for (const auto& tracked_id : tracked_ids) {
-            if (player.steam_id == tracked_id) {
-                result.push_back(player);
-                break;
-            }
+PlayerViews MatchData::get_tracked_players(const TrackedIndex& tracked,
+                                           std::pmr::memory_resource* memory) const {
+    PlayerViews result(memory);
+    for (PlayerRef player : players) {
+        if (tracked.contains(player.steam_id())) {
+            result.push_back(player);
         }
     }
     return result;
@@ -49,12 +52,17 @@ std::string MatchData::get_score_string() const {
     if (team_scores.size() < 2) {
         return "?-?";
     }
-    // Sort by team number for consistent ordering
-    auto scores = team_scores;
-    std::sort(scores.begin(), scores.end(), 
-        [](const TeamScore& a, const TeamScore& b) { return a.team_number < b.team_number; });
-    
-    return std::to_string(scores[0].score) + "-" + std::to_string(scores[1].score);
+    // Lowest two team numbers, in order, for consistent ordering
+    auto by_team = [](const TeamScore& a, const TeamScore& b) { return a.team_number < b.team_number; };
+    auto first = std::min_element(team_scores.begin(), team_scores.end(), by_team);
+    const TeamScore* second = nullptr;
+    for (auto it = team_scores.begin(); it != team_scores.end(); ++it) {
+        if (it != first && (!second || by_team(*it, *second))) {
+            second = &*it;
+        }
+    }
+
+    return std::to_string(first->score) + "-" + std::to_string(second->score);
 }
 
 bool MatchData::is_valid() const {
@@ -65,10 +73,766 @@ bool MatchData::is_valid() const {
 // JSON Parsing functions
 // ============================================================================
 
+namespace {
+
+// Win/loss from the final team scores (false if the team is unknown)
+bool player_won(int team_number, const std::vector<TeamScore>& team_scores) {
+    if (team_number == -1 || team_scores.size() < 2) return false;
+
+    int my_score = 0;
+    int opponent_score = 0;
+    for (const auto& ts : team_scores) {
+        if (ts.team_number == team_number) {
+            my_score = ts.score;
+        } else {
+            opponent_score = ts.score;
+        }
+    }
+    return my_score > opponent_score;
+}
+
+// Scores may come after the stats array, so results are resolved last
+void resolve_match_results(MatchData& match) {
+    const int32_t* teams = match.players.team_number_column();
+    for (size_t i = 0; i < match.players.size(); ++i) {
+        match.players.set_won_match(i, player_won(teams[i], match.team_scores));
+    }
+}
+
+// Raw stats[] values that derived stats are computed from
+struct PlayerInputs {
+#define X(member, type, def, key) type member = def;
+    PLAYER_INPUT_FIELDS(X)
+#undef X
+};
+
+// Stats that aren't read directly from the entry (won_match needs the
+// final scores and is resolved after the whole payload has been read)
+void derive_player_stats(PlayerStats& player, const PlayerInputs& inputs) {
+    // Use "dpr" as ADR (damage per round)
+    player.adr = static_cast<int32_t>(std::lround(inputs.dpr));
+    player.headshot_percentage = (player.kills > 0)
+        ? static_cast<int32_t>(std::lround(100.0 * inputs.total_hs_kills / player.kills))
+        : 0;
+}
+
+// Floats at or beyond this magnitude don't fit an int64; casting them is undefined
+constexpr double kInt64FloatLimit = 9.2e18;
+
+// Integer reading of a JSON float (0 when it doesn't fit an int64)
+int64_t float_to_int(double value) {
+    return std::fabs(value) < kInt64FloatLimit ? static_cast<int64_t>(value) : 0;
+}
+
+template <typename T>
+T from_number(double as_double, int64_t as_int) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return static_cast<T>(as_double);
+    } else if constexpr (std::is_same_v<T, bool>) {
+        return as_int != 0;
+    } else {
+        return static_cast<T>(as_int);
+    }
+}
+
+// Stores a number read for one stats[] key
+using StatSetter = void (*)(PlayerStats& player, PlayerInputs& inputs, double as_double, int64_t as_int);
+
+struct StatKey {
+    std::string_view key;
+    StatSetter set;
+};
+
+// Every numeric stats[] key, generated from the field tables
+const StatKey kStatKeys[] = {
+#define X(member, type, def, key, ...)                                                  \
+    {key, [](PlayerStats& player, PlayerInputs&, double as_double, int64_t as_int) {     \
+         player.member = from_number<type>(as_double, as_int);                          \
+     }},
+    PLAYER_STAT_FIELDS(X)
+#undef X
+#define X(member, type, def, key)                                                       \
+    {key, [](PlayerStats&, PlayerInputs& inputs, double as_double, int64_t as_int) {     \
+         inputs.member = from_number<type>(as_double, as_int);                          \
+     }},
+    PLAYER_INPUT_FIELDS(X)
+#undef X
+};
+
+StatSetter lookup_stat(std::string_view key) {
+    for (const auto& entry : kStatKeys) {
+        if (!entry.key.empty() && entry.key == key) return entry.set;
+    }
+    return nullptr;
+}
+
+// Streams a /v2/matches/{id} payload straight into MatchData. Only
+// map_name, game_finished_at, team_scores[] and stats[] are looked at;
+// everything else is skipped without building a DOM.
+class MatchDetailsSax : public nlohmann::json_sax<json> {
+public:
+    explicit MatchDetailsSax(MatchData& match) : match_(match) {}
+
+    bool has_stats() const { return has_stats_; }
+    size_t stats_size() const { return stats_size_; }
+    const std::string& error() const { return error_; }
+
+    bool null() override { return scalar(); }
+    bool boolean(bool) override { return scalar(); }
+    bool number_integer(number_integer_t val) override {
+        return number(static_cast<double>(val), static_cast<int64_t>(val));
+    }
+    bool number_unsigned(number_unsigned_t val) override {
+        return number(static_cast<double>(val), static_cast<int64_t>(val));
+    }
+    bool number_float(number_float_t val, const string_t&) override {
+        return number(val, float_to_int(val));
+    }
+    bool binary(binary_t&) override { return scalar(); }
+
+    bool string(string_t& val) override {
+        if (depth_ == 1 && root_key_ == RootKey::MapName) {
+            match_.map_name = std::move(val);
+        } else if (depth_ == 1 && root_key_ == RootKey::FinishedAt) {
+            match_.game_finished_at = std::move(val);
+        } else if (depth_ == 3 && section_ == RootKey::Stats) {
+            if (field_ == Field::SteamId) player_.steam_id = SteamId::parse(val).value_or(SteamId());
+            else if (field_ == Field::Name) player_.name = std::move(val);
+        }
+        return scalar();
+    }
+
+    bool start_object(std::size_t) override {
+        element_started();
+        ++depth_;
+        if (depth_ == 3 && section_ != RootKey::None) {
+            in_element_ = true;
+            field_ = Field::None;
+            stat_ = nullptr;
+            player_ = PlayerStats{};
+            inputs_ = PlayerInputs{};
+            team_ = TeamScore{};
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        if (depth_ == 3 && in_element_) {
+            finish_element();
+            in_element_ = false;
+        }
+        --depth_;
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        element_started();
+        ++depth_;
+        if (depth_ == 2 && (root_key_ == RootKey::TeamScores || root_key_ == RootKey::Stats)) {
+            section_ = root_key_;
+            if (section_ == RootKey::Stats) has_stats_ = true;
+        }
+        return true;
+    }
+
+    bool end_array() override {
+        if (depth_ == 2) section_ = RootKey::None;
+        --depth_;
+        return true;
+    }
+
+    bool key(string_t& val) override {
+        if (depth_ == 1) {
+            root_key_ = val == "map_name"         ? RootKey::MapName
+                      : val == "game_finished_at" ? RootKey::FinishedAt
+                      : val == "team_scores"      ? RootKey::TeamScores
+                      : val == "stats"            ? RootKey::Stats
+                                                  : RootKey::None;
+            // A repeated key replaces the earlier value, as in a DOM parse
+            if (root_key_ == RootKey::TeamScores) {
+                match_.team_scores.clear();
+            } else if (root_key_ == RootKey::Stats) {
+                match_.players.clear();
+                has_stats_ = false;
+                stats_size_ = 0;
+            }
+        } else if (depth_ == 3 && in_element_) {
+            field_ = lookup_field(val);
+            stat_ = (field_ == Field::None && section_ == RootKey::Stats) ? lookup_stat(val) : nullptr;
+        }
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+        error_ = ex.what();
+        return false;
+    }
+
+private:
+    enum class RootKey { None, MapName, FinishedAt, TeamScores, Stats };
+    // Keys that aren't numeric player stats (those go through kStatKeys)
+    enum class Field { None, SteamId, Name, TeamNumber, Score };
+
+    Field lookup_field(const std::string& key) const {
+        if (section_ == RootKey::TeamScores) {
+            if (key == "team_number") return Field::TeamNumber;
+            if (key == "score") return Field::Score;
+            return Field::None;
+        }
+        if (key == "steam64_id") return Field::SteamId;
+        if (key == "name") return Field::Name;
+        return Field::None;
+    }
+
+    // A value directly inside team_scores[] / stats[] that isn't an object
+    bool scalar() {
+        element_started();
+        return true;
+    }
+
+    void element_started() {
+        if (depth_ == 2 && section_ == RootKey::Stats) ++stats_size_;
+    }
+
+    bool number(double as_double, int64_t as_int) {
+        element_started();
+        if (depth_ != 3 || !in_element_) return true;
+
+        int value = static_cast<int>(as_int);
+        if (section_ == RootKey::TeamScores) {
+            if (field_ == Field::TeamNumber) team_.team_number = value;
+            else if (field_ == Field::Score) team_.score = value;
+            return true;
+        }
+        if (stat_) stat_(player_, inputs_, as_double, as_int);
+        return true;
+    }
+
+    void finish_element() {
+        if (section_ == RootKey::TeamScores) {
+            match_.team_scores.push_back(team_);
+            return;
+        }
+
+        derive_player_stats(player_, inputs_);
+        match_.players.push_back(player_);
+    }
+
+    MatchData& match_;
+    int depth_ = 0;
+    RootKey root_key_ = RootKey::None;
+    RootKey section_ = RootKey::None;  // Array currently being read (depth 2)
+    Field field_ = Field::None;
+    bool in_element_ = false;
+    bool has_stats_ = false;
+    size_t stats_size_ = 0;
+    std::string error_;
+
+    // Element being filled
+    StatSetter stat_ = nullptr;  // Setter for the current stats[] key
+    PlayerStats player_;
+    PlayerInputs inputs_;
+    TeamScore team_;
+};
+
+// Hand-written parser for the /v2/matches/{id} layout, used by
+// parse_match_details_fast. It reads the same fields as MatchDetailsSax but
+// only accepts a plain, well-formed payload of the expected shape: keys have
+// no escapes and no string uses \u, stats and scores are numbers,
+// team_scores[] / stats[] hold objects and appear once. Anything else makes
+// parse() return false so the caller can hand the body to nlohmann, which
+// keeps the reference behaviour (and error messages) for unusual input.
+class FastMatchDetailsParser {
+public:
+    // With `extended`, unread stats[] values are recorded there
+    FastMatchDetailsParser(std::string_view body, MatchData& match, ExtendedStats* extended = nullptr)
+        : begin_(body.data()), p_(body.data()), end_(body.data() + body.size()),
+          match_(match), extended_(extended) {}
+
+    bool parse() {
+        bool seen_teams = false;
+        bool seen_stats = false;
+        skip_ws();
+        bool ok = parse_object([&](std::string_view key) {
+            if (key == "map_name") return read_string(match_.map_name);
+            if (key == "game_finished_at") return read_string(match_.game_finished_at);
+            if (key == "team_scores") return !std::exchange(seen_teams, true) && parse_team_scores();
+            if (key == "stats") return !std::exchange(seen_stats, true) && parse_stats();
+            return skip_value(1);
+        });
+        skip_ws();
+        return ok && p_ == end_ && seen_stats;
+    }
+
+private:
+    static constexpr int kMaxDepth = 256;
+
+    void skip_ws() {
+        while (p_ != end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) ++p_;
+    }
+
+    bool consume(char c) {
+        if (p_ == end_ || *p_ != c) return false;
+        ++p_;
+        return true;
+    }
+
+    // {"key": value, ...}; `member` reads the value after each key
+    template <typename Member>
+    bool parse_object(Member&& member) {
+        if (!consume('{')) return false;
+        skip_ws();
+        if (consume('}')) return true;
+        do {
+            std::string_view key;
+            skip_ws();
+            if (!read_string(key)) return false;
+            skip_ws();
+            if (!consume(':')) return false;
+            skip_ws();
+            if (!member(key)) return false;
+            skip_ws();
+        } while (consume(','));
+        return consume('}');
+    }
+
+    // [element, ...]; `element` reads each one
+    template <typename Element>
+    bool parse_array(Element&& element) {
+        if (!consume('[')) return false;
+        skip_ws();
+        if (consume(']')) return true;
+        do {
+            skip_ws();
+            if (!element()) return false;
+            skip_ws();
+        } while (consume(','));
+        return consume(']');
+    }
+
+    bool parse_team_scores() {
+        return parse_array([&] {
+            TeamScore team;
+            bool ok = parse_object([&](std::string_view key) {
+                if (key == "team_number") return read_int(team.team_number);
+                if (key == "score") return read_int(team.score);
+                return skip_value(3);
+            });
+            if (ok) match_.team_scores.push_back(team);
+            return ok;
+        });
+    }
+
+    bool parse_stats() {
+        return parse_array([&] {
+            PlayerStats player;
+            PlayerInputs inputs;
+            if (extended_) extended_->begin_player();
+            bool ok = parse_object([&](std::string_view key) {
+                if (key == "steam64_id") {
+                    std::string_view id;
+                    if (!read_string(id)) return false;
+                    player.steam_id = SteamId::parse(id).value_or(SteamId());
+                    return true;
+                }
+                if (key == "name") return read_string(player.name);
+                if (StatSetter set = lookup_stat(key)) {
+                    double as_double = 0.0;
+                    int64_t as_int = 0;
+                    if (!read_number(as_double, as_int)) return false;
+                    set(player, inputs, as_double, as_int);
+                    return true;
+                }
+                const char* value = p_;
+                if (!skip_value(3)) return false;
+                if (extended_) {
+                    extended_->add(static_cast<size_t>(key.data() - begin_), key.size(),
+                                   static_cast<size_t>(value - begin_), static_cast<size_t>(p_ - value));
+                }
+                return true;
+            });
+            if (ok) {
+                derive_player_stats(player, inputs);
+                match_.players.push_back(player);
+            }
+            return ok;
+        });
+    }
+
+    // A string without escape sequences (keys, IDs); `out` points into the body
+    bool read_string(std::string_view& out) {
+        if (!consume('"')) return false;
+        const char* start = p_;
+        for (;;) {
+            p_ += scan_string_run(p_, static_cast<size_t>(end_ - p_));
+            if (p_ == end_) return false;
+            unsigned char c = static_cast<unsigned char>(*p_);
+            if (c == '"') {
+                out = std::string_view(start, static_cast<size_t>(p_ - start));
+                ++p_;
+                return true;
+            }
+            if (c < 0x80 || !skip_utf8()) return false;  // Escape or control character
+        }
+    }
+
+    // A string the match keeps; simple escapes are decoded, \u is left to
+    // nlohmann (which checks surrogate pairs)
+    bool read_string(std::string& out) {
+        if (!consume('"')) return false;
+        out.clear();
+        const char* run = p_;
+        for (;;) {
+            p_ += scan_string_run(p_, static_cast<size_t>(end_ - p_));
+            if (p_ == end_) return false;
+            unsigned char c = static_cast<unsigned char>(*p_);
+            if (c == '"') {
+                out.append(run, static_cast<size_t>(p_ - run));
+                ++p_;
+                return true;
+            }
+            if (c == '\\') {
+                out.append(run, static_cast<size_t>(p_ - run));
+                char decoded = 0;
+                if (!read_escape(decoded)) return false;
+                out.push_back(decoded);
+                run = p_;
+                continue;
+            }
+            if (c < 0x80 || !skip_utf8()) return false;  // Control character
+        }
+    }
+
+    // A string nothing is read from
+    bool skip_string() {
+        if (!consume('"')) return false;
+        for (;;) {
+            p_ += scan_string_run(p_, static_cast<size_t>(end_ - p_));
+            if (p_ == end_) return false;
+            unsigned char c = static_cast<unsigned char>(*p_);
+            if (c == '"') {
+                ++p_;
+                return true;
+            }
+            if (c == '\\') {
+                char decoded = 0;
+                if (!read_escape(decoded)) return false;
+                continue;
+            }
+            if (c < 0x80 || !skip_utf8()) return false;
+        }
+    }
+
+    // A two-character escape sequence at p_ (anything but \u)
+    bool read_escape(char& decoded) {
+        if (end_ - p_ < 2) return false;
+        switch (p_[1]) {
+            case '"': decoded = '"'; break;
+            case '\\': decoded = '\\'; break;
+            case '/': decoded = '/'; break;
+            case 'b': decoded = '\b'; break;
+            case 'f': decoded = '\f'; break;
+            case 'n': decoded = '\n'; break;
+            case 'r': decoded = '\r'; break;
+            case 't': decoded = '\t'; break;
+            default: return false;
+        }
+        p_ += 2;
+        return true;
+    }
+
+    // One well-formed UTF-8 sequence (no overlong forms, surrogates or code
+    // points past U+10FFFF), as nlohmann's lexer requires
+    bool skip_utf8() {
+        size_t left = static_cast<size_t>(end_ - p_);
+        auto byte = [&](size_t i) { return static_cast<unsigned char>(p_[i]); };
+
+        unsigned char lead = byte(0);
+        size_t length = 0;
+        unsigned char low = 0x80;
+        unsigned char high = 0xBF;
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            length = 2;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            length = 3;
+            if (lead == 0xE0) low = 0xA0;
+            if (lead == 0xED) high = 0x9F;
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            length = 4;
+            if (lead == 0xF0) low = 0x90;
+            if (lead == 0xF4) high = 0x8F;
+        } else {
+            return false;
+        }
+        if (left < length || byte(1) < low || byte(1) > high) return false;
+        for (size_t i = 2; i < length; ++i) {
+            if (byte(i) < 0x80 || byte(i) > 0xBF) return false;
+        }
+        p_ += length;
+        return true;
+    }
+
+    bool skip_digits() {
+        const char* start = p_;
+        while (p_ != end_ && *p_ >= '0' && *p_ <= '9') ++p_;
+        return p_ != start;
+    }
+
+    // Advances past a number in JSON's grammar; `integral` if it has no
+    // fraction or exponent
+    bool skip_number(bool& integral) {
+        integral = true;
+        consume('-');
+        if (consume('0')) {
+            // No leading zeros
+        } else if (!skip_digits()) {
+            return false;
+        }
+        if (consume('.')) {
+            integral = false;
+            if (!skip_digits()) return false;
+        }
+        if (p_ != end_ && (*p_ == 'e' || *p_ == 'E')) {
+            integral = false;
+            ++p_;
+            if (!consume('+')) consume('-');
+            if (!skip_digits()) return false;
+        }
+        return true;
+    }
+
+    // The (double, int64) pair MatchDetailsSax::number() gets for the same token
+    bool read_number(double& as_double, int64_t& as_int) {
+        const char* start = p_;
+        bool integral = false;
+        if (!skip_number(integral)) return false;
+
+        if (integral) {
+            // Past int64 nlohmann reports unsigned/float values; not worth copying
+            auto [end, ec] = std::from_chars(start, p_, as_int);
+            if (ec != std::errc() || end != p_) return false;
+            as_double = static_cast<double>(as_int);
+            return true;
+        }
+
+        if (!to_double(start, as_double)) return false;
+        if (!(std::fabs(as_double) < kInt64FloatLimit)) return false;
+        as_int = static_cast<int64_t>(as_double);
+        return true;
+    }
+
+    // A number nothing is read from. nlohmann still converts it, and fails
+    // on floats (or integers too long for uint64) that overflow a double.
+    bool skip_number_value() {
+        const char* start = p_;
+        bool integral = false;
+        if (!skip_number(integral)) return false;
+        if (integral && p_ - start <= 18) return true;
+        double value = 0.0;
+        return to_double(start, value) && std::isfinite(value);
+    }
+
+    // The number token [start, p_) through strtod, like nlohmann, so values
+    // round identically
+    bool to_double(const char* start, double& out) const {
+        char token[64];
+        size_t length = static_cast<size_t>(p_ - start);
+        if (length >= sizeof(token)) return false;
+        std::memcpy(token, start, length);
+        token[length] = '\0';
+        out = std::strtod(token, nullptr);
+        return true;
+    }
+
+    template <typename Int>
+    bool read_int(Int& out) {
+        double as_double = 0.0;
+        int64_t as_int = 0;
+        if (!read_number(as_double, as_int)) return false;
+        out = static_cast<Int>(as_int);
+        return true;
+    }
+
+    bool skip_literal(std::string_view literal) {
+        if (static_cast<size_t>(end_ - p_) < literal.size() ||
+            std::memcmp(p_, literal.data(), literal.size()) != 0) {
+            return false;
+        }
+        p_ += literal.size();
+        return true;
+    }
+
+    // Validates and skips a value nothing is read from
+    bool skip_value(int depth) {
+        if (p_ == end_ || depth > kMaxDepth) return false;
+        switch (*p_) {
+            case '"':
+                return skip_string();
+            case '{':
+                return parse_object([&](std::string_view) { return skip_value(depth + 1); });
+            case '[':
+                return parse_array([&] { return skip_value(depth + 1); });
+            case 't':
+                return skip_literal("true");
+            case 'f':
+                return skip_literal("false");
+            case 'n':
+                return skip_literal("null");
+            default:
+                return skip_number_value();
+        }
+    }
+
+    const char* begin_;
+    const char* p_;
+    const char* end_;
+    MatchData& match_;
+    ExtendedStats* extended_;
+};
+
+// Streams a /v3/profile/matches array (newest first), reading only each
+// entry's id and finished_at. Parsing is aborted as soon as `stop_after`
+// accepts an entry, so the rest of the player's history is never scanned.
+class MatchListSax : public nlohmann::json_sax<json> {
+public:
+    MatchListSax(std::vector<MatchListEntry>& entries, const MatchListStop& stop_after)
+        : entries_(entries), stop_after_(stop_after) {}
+
+    bool stopped() const { return stopped_; }
+
+    bool null() override { return true; }
+    bool boolean(bool) override { return true; }
+    bool number_integer(number_integer_t) override { return true; }
+    bool number_unsigned(number_unsigned_t) override { return true; }
+    bool number_float(number_float_t, const string_t&) override { return true; }
+    bool binary(binary_t&) override { return true; }
+
+    bool string(string_t& val) override {
+        if (depth_ == 2 && in_entry_) {
+            if (field_ == Field::Id) entry_.id = std::move(val);
+            else if (field_ == Field::FinishedAt) entry_.finished_at = std::move(val);
+        }
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        ++depth_;
+        if (depth_ == 2 && root_is_array_) {
+            in_entry_ = true;
+            field_ = Field::None;
+            entry_ = MatchListEntry{};
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        --depth_;
+        if (depth_ != 1 || !in_entry_) return true;
+
+        in_entry_ = false;
+        if (entry_.id.empty()) return true;
+        entries_.push_back(std::move(entry_));
+        if (stop_after_ && stop_after_(entries_.back())) {
+            stopped_ = true;
+            return false;  // Aborts sax_parse
+        }
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        if (depth_ == 0) root_is_array_ = true;
+        ++depth_;
+        return true;
+    }
+
+    bool end_array() override {
+        --depth_;
+        return true;
+    }
+
+    bool key(string_t& val) override {
+        if (depth_ == 2 && in_entry_) {
+            field_ = val == "id"          ? Field::Id
+                   : val == "finished_at" ? Field::FinishedAt
+                                          : Field::None;
+        }
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) override {
+        return false;
+    }
+
+private:
+    enum class Field { None, Id, FinishedAt };
+
+    std::vector<MatchListEntry>& entries_;
+    const MatchListStop& stop_after_;
+    int depth_ = 0;
+    bool root_is_array_ = false;
+    bool in_entry_ = false;
+    bool stopped_ = false;
+    Field field_ = Field::None;
+    MatchListEntry entry_;
+};
+
+}  // namespace
+
 MatchData parse_match_details_from_json(const std::string& body, const std::string& match_id) {
     MatchData match;
     match.match_id = match_id;
 
+    MatchDetailsSax handler(match);
+    if (!json::sax_parse(body, &handler)) {
+        std::cerr << "[parse] JSON parse failed: " << handler.error() << "\n";
+        MatchData failed;
+        failed.match_id = match_id;
+        return failed;
+    }
+
+    if (!handler.has_stats()) {
+        std::cerr << "[parse] Missing stats array\n";
+        match.players.clear();
+        return match;
+    }
+    std::cout << "[parse] stats_size=" << handler.stats_size() << "\n";
+
+    resolve_match_results(match);
+
+    std::cout << "[parse] match.players.size() after loop = " << match.players.size() << "\n";
+    return match;
+}
+
+std::optional<MatchData> parse_match_details_fast(const std::string& body, const std::string& match_id) {
+    MatchData match;
+    match.match_id = match_id;
+
+    FastMatchDetailsParser parser(body, match);
+    if (!parser.parse()) return std::nullopt;
+
+    resolve_match_results(match);
+    return match;
+}
+
+std::optional<MatchData> parse_match_details_extended(std::shared_ptr<const std::string> body,
+                                                      const std::string& match_id) {
+    if (body->size() > UINT32_MAX) return std::nullopt;  // Ranges are stored as 32-bit offsets
+
+    MatchData match;
+    match.match_id = match_id;
+    match.extended = ExtendedStats(body);
+
+    FastMatchDetailsParser parser(*body, match, &match.extended);
+    if (!parser.parse()) return std::nullopt;
+
+    resolve_match_results(match);
+    return match;
+}
+
+MatchData parse_match_details_from_json_dom(const std::string& body, const std::string& match_id) {
+    MatchData match;
+    match.match_id = match_id;
+
     json j;
     try {
         j = json::parse(body);
@@ -110,40 +874,23 @@ MatchData parse_match_details_from_json(const std::string& body, const std::stri
 
         PlayerStats pd{};
 
-        pd.steam_id = s.value("steam64_id", "");
+        pd.steam_id = SteamId::parse(s.value("steam64_id", "")).value_or(SteamId());
         pd.name = s.value("name", "");
-        pd.kills = s.value("total_kills", 0);
-        pd.deaths = s.value("total_deaths", 0);
-        pd.assists = s.value("total_assists", 0);
-        pd.kd_ratio = s.value("kd_ratio", 0.0);
-        pd.team_number = s.value("initial_team_number", -1);
-
-        // Use "dpr" as ADR (damage per round)
-        pd.adr = static_cast<int>(std::lround(s.value("dpr", 0.0)));
 
-        // Calculate headshot percentage
-        int hs_kills = s.value("total_hs_kills", 0);
-        pd.headshot_percentage = (pd.kills > 0)
-            ? static_cast<int>(std::lround(100.0 * hs_kills / pd.kills))
-            : 0;
+        PlayerInputs inputs;
+#define X(member, type, def, key, ...) \
+        if (key[0] != '\0') pd.member = s.value(key, pd.member);
+        PLAYER_STAT_FIELDS(X)
+#undef X
+#define X(member, type, def, key) inputs.member = s.value(key, inputs.member);
+        PLAYER_INPUT_FIELDS(X)
+#undef X
+        derive_player_stats(pd, inputs);
 
         // Determine win/loss from team scores
-        pd.won_match = false;
-        if (pd.team_number != -1 && match.team_scores.size() >= 2) {
-            int my_score = 0;
-            int opponent_score = 0;
-            
-            for (const auto& ts : match.team_scores) {
-                if (ts.team_number == pd.team_number) {
-                    my_score = ts.score;
-                } else {
-                    opponent_score = ts.score;
-                }
-            }
-            pd.won_match = (my_score > opponent_score);
-        }
+        pd.won_match = player_won(pd.team_number, match.team_scores);
 
-        match.players.push_back(std::move(pd));
+        match.players.push_back(pd);
     }
 
     std::cout << "[parse] match.players.size() after loop = " << match.players.size() << "\n";
@@ -151,17 +898,37 @@ MatchData parse_match_details_from_json(const std::string& body, const std::stri
 }
 
 std::string parse_most_recent_match_id(const std::string& body) {
-    json j;
-    try {
-        j = json::parse(body);
-    } catch (...) {
-        return "";
+    std::vector<MatchListEntry> entries = parse_match_list(body, [](const MatchListEntry&) { return true; });
+    return entries.empty() ? std::string() : entries.front().id;
+}
+
+std::vector<MatchListEntry> parse_match_list(const std::string& body, const MatchListStop& stop_after) {
+    std::vector<MatchListEntry> entries;
+    MatchListSax handler(entries, stop_after);
+    if (!json::sax_parse(body, &handler) && !handler.stopped()) {
+        entries.clear();
     }
+    return entries;
+}
 
-    if (!j.is_array() || j.empty()) return "";
+std::optional<int64_t> parse_timestamp_utc(const std::string& timestamp) {
+    int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+    if (std::sscanf(timestamp.c_str(), "%4d-%2d-%2dT%2d:%2d:%2d",
+                    &year, &month, &day, &hour, &minute, &second) != 6) {
+        return std::nullopt;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31) {
+        return std::nullopt;
+    }
 
-    const auto& first = j.at(0);
-    if (!first.is_object()) return "";
+    // Days since 1970-01-01 (proleptic Gregorian calendar)
+    int64_t y = year - (month <= 2 ? 1 : 0);
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t mp = (month + 9) % 12;
+    int64_t doy = (153 * mp + 2) / 5 + day - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    int64_t days = era * 146097 + doe - 719468;
 
-    return first.value("id", "");
+    return days * 86400 + hour * 3600 + minute * 60 + second;
 }
@@ -0,0 +1,303 @@
+#include "match_poller.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+int64_t unix_now() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Whether a list entry is the cursor's match or older than it
+class CursorBound {
+public:
+    explicit CursorBound(const PlayerCursor& cursor)
+        : match_id_(cursor.match_id), finished_at_(parse_timestamp_utc(cursor.finished_at)) {}
+
+    bool at_or_below(const MatchListEntry& entry) const {
+        if (entry.id == match_id_) return true;
+        if (!finished_at_) return false;
+        auto finished_at = parse_timestamp_utc(entry.finished_at);
+        return finished_at && *finished_at <= *finished_at_;
+    }
+
+private:
+    std::string match_id_;
+    std::optional<int64_t> finished_at_;
+};
+
+}  // namespace
+
+CatchupPlan plan_catchup(const std::vector<MatchListEntry>& entries,
+                         const std::optional<PlayerCursor>& cursor,
+                         const std::function<bool(const std::string&)>& is_seen,
+                         size_t limit) {
+    CatchupPlan plan;
+    if (entries.empty()) return plan;
+
+    if (!cursor) {
+        if (!is_seen(entries.front().id)) plan.unseen.push_back(entries.front().id);
+        for (size_t i = 1; i < entries.size(); ++i) {
+            if (!is_seen(entries[i].id)) plan.retire.push_back(entries[i].id);
+        }
+        return plan;
+    }
+
+    CursorBound bound(*cursor);
+    for (const auto& entry : entries) {
+        if (is_seen(entry.id)) {
+            if (bound.at_or_below(entry)) break;
+            continue;
+        }
+        plan.unseen.push_back(entry.id);
+    }
+
+    // Oldest first; anything newer than the limit waits for the next walk
+    std::reverse(plan.unseen.begin(), plan.unseen.end());
+    if (plan.unseen.size() > limit) {
+        plan.left_for_later = plan.unseen.size() - limit;
+        plan.unseen.resize(limit);
+    }
+    return plan;
+}
+
+MatchPoller::MatchPoller(LeetifyClient& leetify, PersistenceManager& persistence,
+                         PlayerCursorStore& cursors, int concurrency, int catchup_max_matches)
+    : leetify_(leetify),
+      persistence_(persistence),
+      cursors_(cursors),
+      pool_(concurrency > 0 ? static_cast<size_t>(concurrency) : 1),
+      catchup_max_matches_(catchup_max_matches > 0 ? static_cast<size_t>(catchup_max_matches) : 1) {}
+
+std::vector<MatchSnapshot> MatchPoller::poll(const std::vector<SteamId>& steam_ids,
+                                         const std::atomic<bool>& running) {
+    auto start = std::chrono::steady_clock::now();
+    last_failed_ids_.clear();
+    CycleState cycle;
+    cycle.tracked_ids.insert(steam_ids.begin(), steam_ids.end());
+    cycle.started_at = unix_now();
+    // After a restart, the persisted cursors know when each player was last read
+    for (const auto& steam_id : steam_ids) {
+        if (last_polled_at_.count(steam_id) > 0) continue;
+        if (auto cursor = cursors_.get(steam_id)) {
+            last_polled_at_[steam_id] = cursor->polled_at;
+        }
+    }
+    size_t coalesced_before = leetify_.coalesced_fetch_count();
+    size_t detail_requests_before = leetify_.detail_requests_sent();
+    size_t list_polls_before = leetify_.list_polls();
+    size_t unchanged_before = leetify_.unchanged_list_polls();
+    leetify_.clear_completed_fetches();
+    std::atomic<size_t> polled{0};
+
+    for (const auto& steam_id : steam_ids) {
+        pool_.submit([this, &steam_id, &cycle, &polled, &running] {
+            if (!running) return;
+            if (poll_player(steam_id, cycle)) {
+                ++polled;
+            }
+        });
+    }
+    pool_.wait();
+
+    for (const auto& [steam_id, cursor] : cycle.pending_cursors) {
+        if (cycle.failed_ids.count(steam_id) > 0) {
+            cursors_.touch(steam_id, cursor.polled_at);
+        } else {
+            cursors_.update(steam_id, cursor.match_id, cursor.finished_at, cursor.polled_at);
+        }
+    }
+    last_failed_ids_ = std::move(cycle.failed_ids);
+
+    if (!cycle.retired_ids.empty()) {
+        for (const auto& match_id : cycle.retired_ids) {
+            persistence_.mark_seen(match_id);
+        }
+        persistence_.save();
+        std::cout << "[poll] Marked " << cycle.retired_ids.size()
+                  << " older match(es) of newly tracked player(s) as seen\n";
+    }
+
+    // Feed matches into the pipeline in the order they were played
+    std::vector<MatchSnapshot> result;
+    result.reserve(cycle.new_matches.size());
+    for (auto& [key, match] : cycle.new_matches) {
+        result.push_back(std::move(match));
+    }
+    std::stable_sort(result.begin(), result.end(), [](const MatchSnapshot& a, const MatchSnapshot& b) {
+        return a->game_finished_at < b->game_finished_at;
+    });
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    last_stats_.players_polled = polled;
+    last_stats_.new_matches = result.size();
+    last_stats_.coalesced_fetches = leetify_.coalesced_fetch_count() - coalesced_before;
+    last_stats_.detail_requests = leetify_.detail_requests_sent() - detail_requests_before;
+    last_stats_.polls_saved = cycle.polls_saved;
+    last_stats_.unchanged_lists = leetify_.unchanged_list_polls() - unchanged_before;
+    size_t cycle_list_polls = leetify_.list_polls() - list_polls_before;
+    total_polls_saved_ += cycle.polls_saved;
+    last_stats_.wall_seconds = elapsed.count();
+
+    std::cout << "[poll] Cycle finished: " << last_stats_.players_polled << " player(s) polled, "
+              << last_stats_.new_matches << " new match(es), "
+              << last_stats_.coalesced_fetches << " coalesced detail fetch(es), "
+              << last_stats_.polls_saved << " poll(s) saved by co-play ("
+              << total_polls_saved_ << " total), "
+              << last_stats_.unchanged_lists << "/" << cycle_list_polls << " list(s) unchanged ("
+              << (leetify_.list_polls() > 0 ? 100 * leetify_.unchanged_list_polls() / leetify_.list_polls() : 0)
+              << "% hit rate overall), "
+              << last_stats_.wall_seconds << "s wall time (" << pool_.size() << " workers)\n";
+
+    return result;
+}
+
+bool MatchPoller::poll_player(SteamId steam_id, CycleState& cycle) {
+    {
+        std::lock_guard<std::mutex> lock(cycle.mutex);
+        if (cycle.resolved_ids.count(steam_id) > 0) {
+            ++cycle.polls_saved;
+            std::cout << "[poll] Skipping Steam ID " + steam_id.to_string() + " (resolved by a co-player's match)\n";
+            return false;
+        }
+    }
+
+    std::cout << "[poll] Checking for new matches for Steam ID: " + steam_id.to_string() + "\n";
+
+    // The first read of a player's list is parsed in full so the list observer
+    // sees their history; later reads stop where plan_catchup's walk would
+    // (the first seen match at or below the cursor), whatever the list's length
+    bool first_read;
+    {
+        std::lock_guard<std::mutex> lock(cycle.mutex);
+        first_read = history_read_.count(steam_id) == 0;
+    }
+    std::optional<PlayerCursor> cursor = cursors_.get(steam_id);
+    MatchListStop stop_after;
+    if (!first_read) {
+        if (cursor) {
+            stop_after = [this, bound = CursorBound(*cursor)](const MatchListEntry& entry) {
+                return persistence_.has_seen(entry.id) && bound.at_or_below(entry);
+            };
+        } else {
+            stop_after = [](const MatchListEntry&) { return true; };
+        }
+    }
+
+    // Fetch only the match list; details are fetched for unseen matches only
+    MatchListResult list = leetify_.poll_match_list(steam_id, stop_after);
+
+    if (list.status == MatchListResult::Status::Unchanged) {
+        {
+            std::lock_guard<std::mutex> lock(cycle.mutex);
+            last_polled_at_[steam_id] = cycle.started_at;
+        }
+        cursors_.touch(steam_id, cycle.started_at);
+        if (persistence_.has_seen(list.newest_id)) {
+            std::cout << "  -> [" + steam_id.to_string() + "] Match list unchanged, skipping\n";
+        } else {
+            // Unchanged but not fully processed (e.g. a detail fetch failed last
+            // time) - make the next poll re-read the list
+            std::cout << "  -> [" + steam_id.to_string() + "] Match list unchanged but not yet processed, will re-read\n";
+            leetify_.forget_list_fingerprint(steam_id);
+        }
+        return true;
+    }
+
+    const std::vector<MatchListEntry>& entries = list.entries;
+    if (entries.empty()) {
+        std::cout << "  -> [" + steam_id.to_string() + "] No match found or fetch failed\n";
+        return true;
+    }
+
+    if (list_observer_) {
+        list_observer_(steam_id, entries);
+    }
+    if (first_read) {
+        std::lock_guard<std::mutex> lock(cycle.mutex);
+        history_read_.insert(steam_id);
+    }
+
+    CatchupPlan plan = plan_catchup(entries, cursor,
+                                    [this](const std::string& id) { return persistence_.has_seen(id); },
+                                    catchup_max_matches_);
+    const std::vector<std::string>& unseen = plan.unseen;
+    if (plan.left_for_later > 0) {
+        std::cout << "  -> [" + steam_id.to_string() + "] Catch-up limit reached, " +
+                     std::to_string(plan.left_for_later) + " newer match(es) left for the next poll\n";
+        // The list won't have changed by then, but it still has to be walked
+        leetify_.forget_list_fingerprint(steam_id);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(cycle.mutex);
+        last_polled_at_[steam_id] = cycle.started_at;
+        cycle.retired_ids.insert(cycle.retired_ids.end(), plan.retire.begin(), plan.retire.end());
+        cycle.pending_cursors[steam_id] =
+            PlayerCursor{entries.front().id, entries.front().finished_at, cycle.started_at};
+    }
+
+    if (unseen.empty()) {
+        std::cout << "  -> [" + steam_id.to_string() + "] Match " + entries.front().id + " already processed, skipping\n";
+        return true;
+    }
+
+    if (unseen.size() > 1) {
+        std::cout << "  -> [" + steam_id.to_string() + "] Catching up on " + std::to_string(unseen.size()) + " unseen matches\n";
+    }
+
+    // Fan the detail fetches out over the pool so a long backlog drains in parallel
+    for (const auto& match_id : unseen) {
+        pool_.submit([this, steam_id, match_id, &cycle] {
+            collect_match(steam_id, match_id, cycle);
+        });
+    }
+    return true;
+}
+
+void MatchPoller::collect_match(SteamId steam_id, const std::string& match_id, CycleState& cycle) {
+    // Friends in the same lobby resolve to the same match ID; the client
+    // coalesces those into a single download
+    MatchSnapshot match = leetify_.fetch_match_details(match_id);
+    if (!match) {
+        std::cout << "  -> [" + steam_id.to_string() + "] Failed to fetch details for match " + match_id + "\n";
+        // Make sure the next poll doesn't skip this list as unchanged
+        leetify_.forget_list_fingerprint(steam_id);
+        std::lock_guard<std::mutex> lock(cycle.mutex);
+        cycle.failed_ids.insert(steam_id);
+        return;
+    }
+
+    mark_participants_resolved(*match, cycle);
+
+    MatchId key = MatchId::from_string(match_id);
+    std::lock_guard<std::mutex> lock(cycle.mutex);
+    if (cycle.new_matches.count(key) > 0) {
+        std::cout << "  -> [" + steam_id.to_string() + "] Match " + match_id + " already collected from another player\n";
+        return;
+    }
+
+    // New match found - add to collection
+    std::cout << "  -> [" + steam_id.to_string() + "] New match found: " + match->match_id + " on " + match->map_name + "\n";
+    cycle.new_matches[key] = std::move(match);
+}
+
+void MatchPoller::mark_participants_resolved(const MatchData& match, CycleState& cycle) {
+    auto finished_at = parse_timestamp_utc(match.game_finished_at);
+    if (!finished_at) return;
+
+    std::lock_guard<std::mutex> lock(cycle.mutex);
+    for (PlayerRef player : match.players) {
+        SteamId steam_id = player.steam_id();
+        if (cycle.tracked_ids.count(steam_id) == 0) continue;
+
+        // Finished after the player's previous poll: nothing in their list
+        // then was newer, and older unseen matches are still above their cursor
+        auto it = last_polled_at_.find(steam_id);
+        if (it != last_polled_at_.end() && *finished_at >= it->second) {
+            cycle.resolved_ids.insert(steam_id);
+        }
+    }
+}
@@ -0,0 +1,186 @@
+#include "poll_planner.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+// Assumed activity for players we have no history for yet
+constexpr double kDefaultMatchesPerWeek = 7.0;
+constexpr int64_t kSecondsPerHour = 3600;
+constexpr int64_t kSecondsPerWeek = 7 * 24 * kSecondsPerHour;
+
+int64_t unix_now() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// 0 = Monday 00:00 UTC ... 167 = Sunday 23:00 UTC (1970-01-01 was a Thursday)
+int hour_of_week(int64_t unix_seconds) {
+    int64_t hours = unix_seconds / kSecondsPerHour;
+    int64_t days = hours / 24;
+    int64_t weekday = (days + 3) % 7;
+    return static_cast<int>(weekday * 24 + hours % 24);
+}
+
+}  // namespace
+
+PollPlanner::PollPlanner(int requests_per_minute)
+    : requests_per_minute_(std::max(0, requests_per_minute)),
+      credit_(requests_per_minute_) {}
+
+std::vector<SteamId> PollPlanner::plan(const std::vector<SteamId>& due_ids,
+                                           std::vector<SteamId>& deferred_ids) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t now = unix_now();
+    refill(now);
+
+    std::vector<SteamId> ordered = due_ids;
+    std::vector<SteamId> planned;
+
+    if (requests_per_minute_ > 0) {
+        // Highest expected value first; ties keep scheduler order
+        std::vector<std::pair<double, SteamId>> scored;
+        scored.reserve(ordered.size());
+        for (const auto& steam_id : ordered) {
+            auto it = players_.find(steam_id);
+            double value = (it == players_.end()) ? 1.0 : poll_value(it->second, now);
+            scored.emplace_back(value, steam_id);
+        }
+        std::stable_sort(scored.begin(), scored.end(),
+            [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        for (auto& [value, steam_id] : scored) {
+            if (credit_ >= 1.0) {
+                credit_ -= 1.0;
+                planned.push_back(std::move(steam_id));
+            } else {
+                deferred_ids.push_back(std::move(steam_id));
+            }
+        }
+    } else {
+        planned = std::move(ordered);
+    }
+
+    for (const auto& steam_id : planned) {
+        PlayerHistory& history = players_[steam_id];
+        history.previous_poll_at = history.last_poll_at;
+        history.last_poll_at = now;
+    }
+
+    polls_planned_ += planned.size();
+    polls_deferred_ += deferred_ids.size();
+    return planned;
+}
+
+void PollPlanner::charge(size_t requests) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (requests_per_minute_ > 0) {
+        credit_ -= static_cast<double>(requests);
+    }
+}
+
+void PollPlanner::refund(size_t requests) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (requests_per_minute_ > 0) {
+        credit_ = std::min(credit_ + static_cast<double>(requests), requests_per_minute_);
+    }
+}
+
+void PollPlanner::observe_matches(SteamId steam_id, const std::vector<MatchListEntry>& entries) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PlayerHistory& history = players_[steam_id];
+    int64_t known_newest = history.newest_finished_at;
+
+    for (const auto& entry : entries) {
+        auto finished_at = parse_timestamp_utc(entry.finished_at);
+        if (!finished_at || *finished_at <= known_newest) continue;
+
+        ++history.finished_by_hour[hour_of_week(*finished_at)];
+        ++history.total_matches;
+        history.newest_finished_at = std::max(history.newest_finished_at, *finished_at);
+        if (history.oldest_finished_at == 0 || *finished_at < history.oldest_finished_at) {
+            history.oldest_finished_at = *finished_at;
+        }
+    }
+}
+
+void PollPlanner::record_detection(SteamId steam_id, const std::string& game_finished_at) {
+    auto finished_at = parse_timestamp_utc(game_finished_at);
+    if (!finished_at) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = players_.find(steam_id);
+    if (it == players_.end() || it->second.previous_poll_at == 0) return;
+
+    const PlayerHistory& history = it->second;
+    double predicted = (history.last_poll_at - history.previous_poll_at) / 2.0;
+    double actual = static_cast<double>(std::max<int64_t>(0, unix_now() - *finished_at));
+
+    ++detections_;
+    predicted_lag_total_ += predicted;
+    actual_lag_total_ += actual;
+}
+
+int PollPlanner::retry_delay_seconds() const {
+    if (requests_per_minute_ <= 0) return 0;
+    return std::max(1, static_cast<int>(std::ceil(60.0 / requests_per_minute_)));
+}
+
+void PollPlanner::log_summary() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::cout << "[planner] ";
+    if (requests_per_minute_ > 0) {
+        std::cout << "Budget " << requests_per_minute_ << " req/min, credit "
+                  << static_cast<int>(credit_) << ", ";
+    }
+    std::cout << polls_planned_ << " poll(s) planned, " << polls_deferred_ << " deferred";
+    if (detections_ > 0) {
+        std::cout << "; detection lag over " << detections_ << " match(es): predicted avg "
+                  << static_cast<int>(predicted_lag_total_ / detections_) << "s, actual avg "
+                  << static_cast<int>(actual_lag_total_ / detections_) << "s";
+    }
+    std::cout << "\n";
+}
+
+void PollPlanner::refill(int64_t now_unix) {
+    if (last_refill_at_ != 0 && now_unix > last_refill_at_) {
+        credit_ += requests_per_minute_ * (now_unix - last_refill_at_) / 60.0;
+        credit_ = std::min(credit_, requests_per_minute_);
+    }
+    last_refill_at_ = now_unix;
+}
+
+double PollPlanner::expected_matches(const PlayerHistory& history, int64_t from_unix, int64_t to_unix) const {
+    if (to_unix <= from_unix) return 0.0;
+
+    double matches_per_week = kDefaultMatchesPerWeek;
+    if (history.total_matches > 0) {
+        double weeks = std::max(1.0, static_cast<double>(history.newest_finished_at - history.oldest_finished_at) /
+                                         kSecondsPerWeek);
+        matches_per_week = history.total_matches / weeks;
+    }
+
+    // Whole weeks contribute the full weekly rate; walk the remainder hour by hour
+    int64_t span = to_unix - from_unix;
+    double expected = matches_per_week * static_cast<double>(span / kSecondsPerWeek);
+    int64_t t = to_unix - span % kSecondsPerWeek;
+
+    // Laplace-smoothed share of matches that finish in each hour-of-week slot
+    double denominator = history.total_matches + static_cast<double>(kHoursPerWeek);
+    while (t < to_unix) {
+        int64_t next_hour = (t / kSecondsPerHour + 1) * kSecondsPerHour;
+        int64_t segment_end = std::min(next_hour, to_unix);
+        double share = (history.finished_by_hour[hour_of_week(t)] + 1.0) / denominator;
+        expected += matches_per_week * share * static_cast<double>(segment_end - t) / kSecondsPerHour;
+        t = segment_end;
+    }
+    return expected;
+}
+
+double PollPlanner::poll_value(const PlayerHistory& history, int64_t now_unix) const {
+    // Never polled: always worth a look
+    if (history.last_poll_at == 0) return 1.0;
+    return 1.0 - std::exp(-expected_matches(history, history.last_poll_at, now_unix));
+}
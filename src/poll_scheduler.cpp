@@ -0,0 +1,95 @@
+#include "poll_scheduler.h"
+#include <algorithm>
+
+PollScheduler::PollScheduler(int base_interval_seconds, int active_interval_seconds, int max_interval_seconds)
+    : base_interval_(std::max(1, base_interval_seconds)),
+      active_interval_(std::max(1, std::min(active_interval_seconds, base_interval_seconds))),
+      max_interval_(std::max(base_interval_seconds, max_interval_seconds)) {}
+
+void PollScheduler::add_player(SteamId steam_id, Clock::time_point first_due) {
+    PlayerState& state = players_[steam_id];
+    state.interval = base_interval_;
+    schedule(steam_id, state, first_due);
+}
+
+std::vector<SteamId> PollScheduler::pop_due(Clock::time_point now) {
+    std::vector<SteamId> due;
+    while (!heap_.empty() && heap_.top().due <= now) {
+        HeapEntry entry = heap_.top();
+        heap_.pop();
+
+        auto it = players_.find(entry.steam_id);
+        if (it == players_.end() || it->second.generation != entry.generation) {
+            continue;  // Superseded by a later reschedule
+        }
+        due.push_back(std::move(entry.steam_id));
+    }
+    return due;
+}
+
+void PollScheduler::record_poll(SteamId steam_id, PollOutcome outcome, Clock::time_point now) {
+    auto it = players_.find(steam_id);
+    if (it == players_.end()) return;
+
+    PlayerState& state = it->second;
+    switch (outcome) {
+        case PollOutcome::NewMatch:
+            state.interval = active_interval_;
+            break;
+        case PollOutcome::NothingNew:
+            state.interval = std::min(max_interval_, std::max(base_interval_, state.interval * 2));
+            break;
+        case PollOutcome::FetchFailed:
+            schedule(steam_id, state, now + active_interval_);
+            return;
+    }
+    schedule(steam_id, state, now + state.interval);
+}
+
+void PollScheduler::postpone(SteamId steam_id, Clock::time_point due) {
+    auto it = players_.find(steam_id);
+    if (it == players_.end()) return;
+    schedule(steam_id, it->second, due);
+}
+
+std::optional<PollScheduler::Clock::time_point> PollScheduler::next_due() {
+    drop_stale_entries();
+    if (heap_.empty()) return std::nullopt;
+    return heap_.top().due;
+}
+
+std::chrono::seconds PollScheduler::interval_for(SteamId steam_id) const {
+    auto it = players_.find(steam_id);
+    return it == players_.end() ? std::chrono::seconds(0) : it->second.interval;
+}
+
+void PollScheduler::schedule(SteamId steam_id, PlayerState& state, Clock::time_point due) {
+    ++state.generation;
+    heap_.push(HeapEntry{due, state.generation, steam_id});
+
+    // Lazy deletion leaves stale entries behind; rebuild if they pile up
+    if (heap_.size() > 2 * players_.size() + 64) {
+        std::vector<HeapEntry> live;
+        live.reserve(players_.size());
+        while (!heap_.empty()) {
+            const HeapEntry& top = heap_.top();
+            auto it = players_.find(top.steam_id);
+            if (it != players_.end() && it->second.generation == top.generation) {
+                live.push_back(top);
+            }
+            heap_.pop();
+        }
+        for (auto& entry : live) {
+            heap_.push(std::move(entry));
+        }
+    }
+}
+
+void PollScheduler::drop_stale_entries() {
+    while (!heap_.empty()) {
+        const HeapEntry& top = heap_.top();
+        auto it = players_.find(top.steam_id);
+        if (it != players_.end() && it->second.generation == top.generation) return;
+        heap_.pop();
+    }
+}
@@ -0,0 +1,81 @@
+#include "rate_limiter.h"
+#include <algorithm>
+#include <iostream>
+
+RateLimiter::RateLimiter(int requests_per_minute, int burst)
+    : tokens_per_second_(requests_per_minute > 0 ? requests_per_minute / 60.0 : 0.0),
+      capacity_(std::max(1, burst)),
+      tokens_(capacity_),
+      last_refill_(Clock::now()),
+      paused_until_(Clock::now()) {}
+
+void RateLimiter::acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto start = Clock::now();
+
+    while (true) {
+        auto now = Clock::now();
+        if (now < paused_until_) {
+            cv_.wait_until(lock, paused_until_);
+            continue;
+        }
+
+        // No client-side limit configured
+        if (tokens_per_second_ <= 0.0) break;
+
+        refill(now);
+        if (tokens_ >= 1.0) {
+            tokens_ -= 1.0;
+            break;
+        }
+
+        auto until_next_token = std::chrono::duration<double>((1.0 - tokens_) / tokens_per_second_);
+        cv_.wait_for(lock, until_next_token);
+    }
+
+    auto waited = Clock::now() - start;
+    if (waited > std::chrono::milliseconds(1)) {
+        total_wait_ += waited;
+        ++waits_;
+    }
+}
+
+void RateLimiter::pause_for(std::chrono::milliseconds delay) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    paused_until_ = std::max(paused_until_, Clock::now() + delay);
+}
+
+void RateLimiter::observe_quota(long remaining, std::chrono::seconds reset_in) {
+    if (remaining > 0 || reset_in.count() <= 0) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    paused_until_ = std::max(paused_until_, Clock::now() + reset_in);
+}
+
+void RateLimiter::record_throttled() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++throttled_;
+}
+
+double RateLimiter::total_wait_seconds() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::chrono::duration<double>(total_wait_).count();
+}
+
+size_t RateLimiter::throttled_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return throttled_;
+}
+
+void RateLimiter::log_summary() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::cout << "[ratelimit] " << waits_ << " request(s) queued, "
+              << std::chrono::duration<double>(total_wait_).count() << "s total wait, "
+              << throttled_ << " throttled (429) response(s)\n";
+}
+
+void RateLimiter::refill(Clock::time_point now) {
+    double elapsed = std::chrono::duration<double>(now - last_refill_).count();
+    tokens_ = std::min(capacity_, tokens_ + elapsed * tokens_per_second_);
+    last_refill_ = now;
+}
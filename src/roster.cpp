@@ -0,0 +1,53 @@
+#include "roster.h"
+#include <cstring>
+#include <iomanip>
+
+// ============================================================================
+// Prompt/report formatting
+// ============================================================================
+
+namespace {
+
+void write_value(std::ostream& out, double value, StatFormat format) {
+    if (format == StatFormat::Fixed2) {
+        out << std::fixed << std::setprecision(2) << value;
+    } else {
+        out << value;
+    }
+    if (format == StatFormat::Percent) out << "%";
+}
+
+template <typename T>
+void write_value(std::ostream& out, T value, StatFormat format) {
+    if (format == StatFormat::Fixed2) {
+        write_value(out, static_cast<double>(value), format);
+        return;
+    }
+    out << +value;
+    if (format == StatFormat::Percent) out << "%";
+}
+
+}  // namespace
+
+void write_stats(std::ostream& out, PlayerRef player, StatMask mask, const StatStyle& style) {
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    const char* previous_label = nullptr;
+
+#define X(member, type, def, key, label, format)                                   \
+    if ((mask & stat_bit(PlayerStat::member)) != 0 && label[0] != '\0') {          \
+        if (previous_label && std::strcmp(previous_label, label) == 0) {           \
+            out << "/";                                                            \
+        } else {                                                                   \
+            if (previous_label) out << style.separator;                            \
+            out << label << style.label_separator;                                 \
+        }                                                                          \
+        previous_label = label;                                                    \
+        write_value(out, player.member(), format);                                 \
+    }
+    PLAYER_STAT_FIELDS(X)
+#undef X
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,30 @@
+#include "transfer_stats.h"
+#include <algorithm>
+#include <iostream>
+
+TransferStats& TransferStats::global() {
+    static TransferStats stats;
+    return stats;
+}
+
+void TransferStats::record(const std::string& endpoint, size_t wire_bytes, size_t decoded_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Counters& counters = endpoints_[endpoint];
+    ++counters.responses;
+    counters.wire_bytes += wire_bytes;
+    counters.decoded_bytes += decoded_bytes;
+}
+
+void TransferStats::log_summary() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [endpoint, counters] : endpoints_) {
+        std::cout << "[transfer] " << endpoint << ": " << counters.responses << " response(s), "
+                  << counters.wire_bytes / 1024 << " KiB on wire, "
+                  << counters.decoded_bytes / 1024 << " KiB decoded";
+        if (counters.wire_bytes > 0) {
+            std::cout << " (" << (100 * counters.wire_bytes / std::max<size_t>(1, counters.decoded_bytes))
+                      << "% of decoded size)";
+        }
+        std::cout << "\n";
+    }
+}
@@ -0,0 +1,131 @@
+// plan_catchup: which entries of a player's match list get fetched
+#include "check.h"
+#include "match_poller.h"
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+using Ids = std::vector<std::string>;
+
+struct Player {
+    std::vector<MatchListEntry> list;  // Newest first
+    std::optional<PlayerCursor> cursor;
+    std::unordered_set<std::string> seen;
+
+    CatchupPlan plan(size_t limit = 10) const {
+        return plan_catchup(list, cursor, [this](const std::string& id) { return seen.count(id) > 0; }, limit);
+    }
+
+    // What the poller does after a cycle: the cursor moves to the newest
+    // entry and every fetched match is posted (marked seen)
+    void finish_cycle(const CatchupPlan& plan) {
+        cursor = PlayerCursor{list.front().id, list.front().finished_at, 0};
+        for (const auto& id : plan.unseen) seen.insert(id);
+        for (const auto& id : plan.retire) seen.insert(id);
+    }
+};
+
+MatchListEntry match(const std::string& id, int minute) {
+    std::string mm = (minute < 10 ? "0" : "") + std::to_string(minute);
+    return {id, "2024-05-12T19:" + mm + ":00.000Z"};
+}
+
+// B played an older match alone and a newer one with tracked player A. A's
+// list posted the newer one and resolved B, so B's list wasn't read.
+void older_match_survives_co_player_resolution() {
+    Player b;
+    b.list = {match("with-a", 40), match("solo", 20), match("cursor", 5)};
+    b.cursor = PlayerCursor{"cursor", "2024-05-12T19:05:00.000Z", 0};
+    b.seen = {"cursor", "with-a"};
+
+    CatchupPlan plan = b.plan();
+    CHECK(plan.unseen == Ids{"solo"});
+    CHECK(plan.retire.empty());
+}
+
+void stops_at_cursor_without_timestamps() {
+    Player p;
+    p.list = {{"new", ""}, {"cursor", ""}, {"older-unseen", ""}};
+    p.cursor = PlayerCursor{"cursor", "", 0};
+    p.seen = {"cursor"};
+    CHECK(p.plan().unseen == Ids{"new"});
+}
+
+void failed_fetch_is_retried() {
+    // The poller keeps the old cursor when a detail fetch failed
+    Player p;
+    p.list = {match("newest", 50), match("failed", 30), match("posted", 10)};
+    p.cursor = PlayerCursor{"posted", "2024-05-12T19:10:00.000Z", 0};
+    p.seen = {"newest", "posted"};
+    CHECK(p.plan().unseen == Ids{"failed"});
+}
+
+void unposted_matches_at_the_cursor_are_fetched_again() {
+    // The tracker stopped after the list read but before posting
+    Player p;
+    p.list = {match("newest", 50), match("older", 30), match("posted", 10)};
+    p.cursor = PlayerCursor{"newest", "2024-05-12T19:50:00.000Z", 0};
+    p.seen = {"posted"};
+    CHECK((p.plan().unseen == Ids{"older", "newest"}));
+}
+
+void newly_tracked_player_posts_only_the_newest() {
+    Player p;
+    p.list = {match("c", 30), match("b", 20), match("a", 10)};
+
+    CatchupPlan plan = p.plan();
+    CHECK(plan.unseen == Ids{"c"});
+    CHECK((plan.retire == Ids{"b", "a"}));
+
+    p.finish_cycle(plan);
+    CHECK(p.plan().unseen.empty());
+}
+
+void limit_drains_oldest_first_over_several_polls() {
+    Player p;
+    p.list = {match("u5", 50), match("u4", 40), match("u3", 30), match("u2", 20), match("u1", 10),
+              match("cursor", 5)};
+    p.cursor = PlayerCursor{"cursor", "2024-05-12T19:05:00.000Z", 0};
+    p.seen = {"cursor"};
+
+    CatchupPlan first = p.plan(2);
+    CHECK((first.unseen == Ids{"u1", "u2"}));
+    CHECK(first.left_for_later == 3);
+    p.finish_cycle(first);
+
+    CatchupPlan second = p.plan(2);
+    CHECK((second.unseen == Ids{"u3", "u4"}));
+    CHECK(second.left_for_later == 1);
+    p.finish_cycle(second);
+
+    CatchupPlan third = p.plan(2);
+    CHECK(third.unseen == Ids{"u5"});
+    CHECK(third.left_for_later == 0);
+    p.finish_cycle(third);
+
+    CHECK(p.plan(2).unseen.empty());
+}
+
+void nothing_new() {
+    Player p;
+    p.list = {match("cursor", 30), match("older", 20)};
+    p.cursor = PlayerCursor{"cursor", "2024-05-12T19:30:00.000Z", 0};
+    p.seen = {"cursor"};
+    CHECK(p.plan().unseen.empty());
+    CHECK(plan_catchup({}, p.cursor, [](const std::string&) { return false; }, 10).unseen.empty());
+}
+
+}  // namespace
+
+int main() {
+    older_match_survives_co_player_resolution();
+    stops_at_cursor_without_timestamps();
+    failed_fetch_is_retried();
+    unposted_matches_at_the_cursor_are_fetched_again();
+    newly_tracked_player_posts_only_the_newest();
+    limit_drains_oldest_first_over_several_polls();
+    nothing_new();
+    return test_result();
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+
+// Minimal assertions for the test executables: failures are printed and
+// counted, and test_result() turns the count into the exit code
+
+inline int& test_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                               \
+    do {                                                                               \
+        if (!(condition)) {                                                            \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #condition "\n"; \
+            ++test_failures();                                                         \
+        }                                                                              \
+    } while (0)
+
+inline int test_result() {
+    if (test_failures() > 0) {
+        std::cerr << test_failures() << " check(s) failed\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
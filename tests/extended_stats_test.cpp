@@ -0,0 +1,84 @@
+// ExtendedStats: stats[] values recorded as slices by the extended parse
+#include "check.h"
+#include "match_payloads.h"
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace {
+
+std::optional<MatchData> parse_extended(const std::string& body) {
+    QuietLogs quiet;
+    return parse_match_details_extended(std::make_shared<const std::string>(body), "m");
+}
+
+void values_are_decoded_on_demand() {
+    std::optional<MatchData> match = parse_extended(
+        R"({"stats":[{"name":"a","mvps":3,"flashbang_hit_foe":2.5,"x":[1,{"y":2}],"tag":"str"},)"
+        R"({"name":"b"}]})");
+    CHECK(match && match->extended.player_count() == 2);
+    if (!match) return;
+
+    const ExtendedStats& extended = match->extended;
+    CHECK(extended.number(0, "mvps") == 3.0);
+    CHECK(extended.number(0, "flashbang_hit_foe") == 2.5);
+    CHECK(extended.raw(0, "x") == std::string_view(R"([1,{"y":2}])"));
+    CHECK(extended.raw(0, "tag") == std::string_view(R"("str")"));
+    CHECK(!extended.number(0, "tag"));
+    CHECK(!extended.number(1, "mvps"));
+    // Stats the roster reads aren't recorded again
+    CHECK(!extended.raw(0, "name"));
+    CHECK(!extended.raw(2, "mvps"));
+}
+
+void last_repeated_key_wins() {
+    std::optional<MatchData> match = parse_extended(R"({"stats":[{"mvps":1,"multi3k":2,"mvps":4}]})");
+    CHECK(match);
+    if (!match) return;
+    CHECK(match->extended.number(0, "mvps") == 4.0);
+    CHECK(match->extended.number(0, "multi3k") == 2.0);
+}
+
+void player_without_values_in_the_middle() {
+    std::optional<MatchData> match = parse_extended(
+        R"({"stats":[{"name":"a","mvps":1},{"name":"b","total_kills":7},{"name":"c","mvps":3}]})");
+    CHECK(match && match->extended.player_count() == 3);
+    if (!match) return;
+
+    const ExtendedStats& extended = match->extended;
+    CHECK(extended.number(0, "mvps") == 1.0);
+    CHECK(!extended.raw(1, "mvps"));
+    CHECK(extended.number(2, "mvps") == 3.0);
+    CHECK(match->players[1].kills() == 7);
+
+    std::ostringstream line;
+    write_extended_stats(line, extended, 1);
+    CHECK(line.str().empty());
+    write_extended_stats(line, extended, 2);
+    CHECK(line.str() == ", MVPs 3");
+}
+
+void formatting() {
+    std::optional<MatchData> match = parse_extended(
+        R"({"stats":[{"he_foes_damage_avg":12.345,"multi5k":1,"mvps":2.6}]})");
+    CHECK(match);
+    if (!match) return;
+
+    std::ostringstream line;
+    line << 1.5;
+    write_extended_stats(line, match->extended, 0);
+    CHECK(line.str() == "1.5, MVPs 3, Aces 1, HE dmg/nade 12.35");
+    // The stream's own formatting is restored
+    line << " " << 1.5;
+    CHECK(line.str() == "1.5, MVPs 3, Aces 1, HE dmg/nade 12.35 1.5");
+}
+
+}  // namespace
+
+int main() {
+    values_are_decoded_on_demand();
+    last_repeated_key_wins();
+    player_without_values_in_the_middle();
+    formatting();
+    return test_result();
+}
@@ -0,0 +1,97 @@
+// parse_match_details_fast / _extended against parse_match_details_from_json:
+// whenever the fast path accepts a payload, the result must match
+#include "check.h"
+#include "match_payloads.h"
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Parsed {
+    MatchData reference;
+    std::optional<MatchData> fast;
+    std::optional<MatchData> extended;
+};
+
+Parsed parse_all(const std::string& body) {
+    QuietLogs quiet;
+    Parsed parsed;
+    parsed.reference = parse_match_details_from_json(body, "m");
+    parsed.fast = parse_match_details_fast(body, "m");
+    parsed.extended = parse_match_details_extended(std::make_shared<const std::string>(body), "m");
+    return parsed;
+}
+
+// True if the fast path accepted the payload; a mismatch is a failed check
+bool check_against_reference(const std::string& body) {
+    Parsed parsed = parse_all(body);
+    CHECK(parsed.fast.has_value() == parsed.extended.has_value());
+    if (!parsed.fast) return false;
+
+    bool agree = same_match(*parsed.fast, parsed.reference) &&
+                 (!parsed.extended || same_match(*parsed.extended, parsed.reference));
+    if (!agree) std::cerr << "fast parse differs on: " << body.substr(0, 200) << "\n";
+    CHECK(agree);
+    return true;
+}
+
+// Byte flips, deletions, insertions of JSON punctuation, truncation and
+// number characters: the fast path may reject these, but must never
+// accept one and read it differently
+std::string mutate(std::string body, std::mt19937& rng) {
+    static const char kPunctuation[] = "{}[],:\"\\0-e.tn ";
+    static const char kNumber[] = "0123456789-+.eE";
+    int operations = 1 + static_cast<int>(rng() % 3);
+    for (int op = 0; op < operations && !body.empty(); ++op) {
+        size_t i = rng() % body.size();
+        switch (rng() % 5) {
+            case 0: body[i] = static_cast<char>(rng() % 256); break;
+            case 1: body.erase(i, 1 + rng() % 4); break;
+            case 2: body.insert(i, 1, kPunctuation[rng() % (sizeof(kPunctuation) - 1)]); break;
+            case 3: body.resize(i); break;
+            case 4: body[i] = kNumber[rng() % (sizeof(kNumber) - 1)]; break;
+        }
+    }
+    return body;
+}
+
+void generated_and_mutated_payloads() {
+    std::mt19937 rng(7);
+    for (int variant = 0; variant < 500; ++variant) {
+        std::string body = make_match_payload(rng, variant);
+        // Well-formed payloads of the expected shape always take the fast path
+        CHECK(check_against_reference(body));
+        for (int i = 0; i < 20; ++i) check_against_reference(mutate(body, rng));
+    }
+}
+
+void edge_cases() {
+    const std::vector<std::string> bodies = {
+        "{}",
+        "[]",
+        R"({"stats":[]})",
+        R"({"stats":[]} x)",
+        "\xEF\xBB\xBF{\"stats\":[]}",
+        R"({"stats":[{"total_kills":1e2}]})",
+        R"({"stats":[{"total_kills":-0}],"stats":[]})",
+        R"({"team_scores":[{"score":1}],"stats":[],"team_scores":[{"score":2}]})",
+        R"({"stats":[{"name":"é🔥"}]})",
+        R"({"stats":[{"kd_ratio":1.00000000000000011102230246251565404236316680908203125}]})",
+        R"({"stats":[{"total_kills":99999999999999999999}]})",
+        R"({"stats":[{"x":1e999}]})",
+        "{\"stats\":[{\"x\":\"\xED\xA0\x80\"}]}",
+        "{\"stats\":[{\"x\":\"\xF4\x90\x80\x80\"}]}",
+        R"({"stats":[{"x":01}]})",
+    };
+    for (const auto& body : bodies) check_against_reference(body);
+}
+
+}  // namespace
+
+int main() {
+    generated_and_mutated_payloads();
+    edge_cases();
+    return test_result();
+}
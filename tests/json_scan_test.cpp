@@ -0,0 +1,60 @@
+// Every string scan kernel the CPU can run agrees with the scalar one
+#include "check.h"
+#include "json_scan.h"
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool kernels_agree(const std::vector<JsonScanBackend>& backends, const std::string& text) {
+    size_t expected = backends.front().scan(text.data(), text.size());
+    for (const auto& backend : backends) {
+        size_t found = backend.scan(text.data(), text.size());
+        if (found != expected) {
+            std::cerr << backend.name << " returned " << found << ", scalar " << expected
+                      << " (length " << text.size() << ")\n";
+            return false;
+        }
+    }
+    return scan_string_run(text.data(), text.size()) == expected;
+}
+
+// Each byte value at every position of buffers around the 16/32 byte blocks
+void every_byte_at_every_position(const std::vector<JsonScanBackend>& backends) {
+    for (size_t length : {1, 15, 16, 17, 31, 32, 33, 64, 70}) {
+        for (size_t position = 0; position < length; ++position) {
+            for (int byte = 0; byte < 256; ++byte) {
+                std::string text(length, 'a');
+                text[position] = static_cast<char>(byte);
+                CHECK(kernels_agree(backends, text));
+            }
+        }
+    }
+}
+
+void random_strings(const std::vector<JsonScanBackend>& backends) {
+    std::mt19937 rng(5);
+    for (int i = 0; i < 100000; ++i) {
+        std::string text(rng() % 100, 'a');
+        for (auto& c : text) {
+            unsigned pick = rng() % 16;
+            c = pick == 0 ? static_cast<char>(rng() % 256) : pick == 1 ? '"' : static_cast<char>('a' + pick);
+        }
+        if (rng() % 3 == 0) text.assign(rng() % 80, 'x');
+        CHECK(kernels_agree(backends, text));
+    }
+}
+
+}  // namespace
+
+int main() {
+    std::vector<JsonScanBackend> backends = json_scan_backends();
+    std::cout << "scan kernels:";
+    for (const auto& backend : backends) std::cout << " " << backend.name;
+    std::cout << " (in use: " << json_scan_backend() << ")\n";
+
+    every_byte_at_every_position(backends);
+    random_strings(backends);
+    return test_result();
+}
@@ -0,0 +1,108 @@
+// Binary match format: round trips, damaged buffers and mapped files
+#include "check.h"
+#include "match_binary.h"
+#include "match_payloads.h"
+#include <filesystem>
+#include <random>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+MatchData parse(const std::string& body, const std::string& match_id) {
+    QuietLogs quiet;
+    return parse_match_details_from_json(body, match_id);
+}
+
+void round_trip() {
+    std::mt19937 rng(7);
+    for (int variant = 0; variant < 100; ++variant) {
+        MatchData match = parse(make_match_payload(rng, variant), "match-" + std::to_string(variant));
+        std::string encoded = encode_match(match);
+
+        std::string error;
+        std::optional<MatchView> view = MatchView::open(encoded.data(), encoded.size(), &error);
+        CHECK(view);
+        if (!view) {
+            std::cerr << "open failed: " << error << "\n";
+            continue;
+        }
+        CHECK(view->version() == kMatchFormatVersion);
+        CHECK(same_match(view->to_match_data(), match));
+
+        // The accessors read the same values in place
+        CHECK(view->player_count() == match.players.size());
+        for (size_t i = 0; i < view->player_count(); ++i) {
+            CHECK(view->steam_id(i) == match.players[i].steam_id());
+            CHECK(view->name(i) == match.players[i].name());
+#define X(member, ...) CHECK(view->member(i) == match.players[i].member());
+            PLAYER_STAT_FIELDS(X)
+#undef X
+        }
+    }
+}
+
+void empty_match() {
+    MatchData match = parse(R"({"stats":[]})", "empty");
+    std::string encoded = encode_match(match);
+    std::optional<MatchView> view = MatchView::open(encoded.data(), encoded.size());
+    CHECK(view && view->player_count() == 0 && view->team_count() == 0);
+    CHECK(view && same_match(view->to_match_data(), match));
+}
+
+void damaged_buffers() {
+    std::mt19937 rng(11);
+    MatchData match = parse(make_match_payload(rng, 1), "damaged");
+    std::string encoded = encode_match(match);
+
+    // Every truncation is rejected
+    for (size_t size = 0; size < encoded.size(); ++size) {
+        CHECK(!MatchView::open(encoded.data(), size));
+    }
+
+    std::string bad_magic = encoded;
+    bad_magic[0] ^= 0x01;
+    CHECK(!MatchView::open(bad_magic.data(), bad_magic.size()));
+
+    // A flipped bit either fails validation or still reads within the buffer
+    for (int flip = 0; flip < 2000; ++flip) {
+        std::string damaged = encoded;
+        damaged[rng() % damaged.size()] ^= static_cast<char>(1 << (rng() % 8));
+        if (std::optional<MatchView> view = MatchView::open(damaged.data(), damaged.size())) {
+            MatchData read = view->to_match_data();
+            CHECK(read.players.size() == view->player_count());
+        }
+    }
+}
+
+void mapped_file() {
+    fs::path dir = fs::temp_directory_path() / "csh_match_binary";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    std::mt19937 rng(3);
+    MatchData match = parse(make_match_payload(rng, 2), "mapped");
+    std::string path = (dir / "mapped.bin").string();
+    CHECK(write_match_file(path, match));
+
+    MappedMatchFile file;
+    std::string error;
+    CHECK(file.open(path, &error));
+    CHECK(file.view() && same_match(file.view()->to_match_data(), match));
+
+    MappedMatchFile missing;
+    CHECK(!missing.open((dir / "missing.bin").string(), &error));
+    CHECK(!missing.view());
+    fs::remove_all(dir);
+}
+
+}  // namespace
+
+int main() {
+    round_trip();
+    empty_match();
+    damaged_buffers();
+    mapped_file();
+    return test_result();
+}
@@ -0,0 +1,76 @@
+// MatchCache: corrupt files are dropped and can be replaced
+#include "check.h"
+#include "match_cache.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const std::string kBody = R"({"map_name":"de_inferno","stats":[]})";
+
+fs::path fresh_dir(const std::string& name) {
+    fs::path dir = fs::temp_directory_path() / ("csh_" + name);
+    fs::remove_all(dir);
+    return dir;
+}
+
+void round_trip() {
+    fs::path dir = fresh_dir("cache_round_trip");
+    MatchCache cache(dir.string(), 1024 * 1024);
+    cache.load();
+
+    CHECK(!cache.get("m1"));
+    cache.put("m1", kBody);
+    CHECK(cache.get("m1") == kBody);
+    CHECK(cache.hits() == 1);
+    CHECK(cache.misses() == 1);
+
+    // Entries survive a restart
+    MatchCache reloaded(dir.string(), 1024 * 1024);
+    reloaded.load();
+    CHECK(reloaded.get("m1") == kBody);
+    fs::remove_all(dir);
+}
+
+void corrupt_file_is_dropped_and_replaced() {
+    fs::path dir = fresh_dir("cache_corrupt");
+    MatchCache cache(dir.string(), 1024 * 1024);
+    cache.load();
+    cache.put("m1", kBody);
+
+    std::ofstream(dir / "m1.json.gz", std::ios::binary | std::ios::trunc) << "not gzip";
+    CHECK(!cache.get("m1"));
+    CHECK(!fs::exists(dir / "m1.json.gz"));
+    CHECK(cache.hits() == 0);
+
+    cache.put("m1", kBody);
+    CHECK(cache.get("m1") == kBody);
+    fs::remove_all(dir);
+}
+
+void put_replaces_and_evict_removes() {
+    fs::path dir = fresh_dir("cache_replace");
+    MatchCache cache(dir.string(), 1024 * 1024);
+    cache.load();
+
+    cache.put("m1", "{}");
+    cache.put("m1", kBody);
+    CHECK(cache.get("m1") == kBody);
+
+    cache.evict("m1");
+    CHECK(!cache.get("m1"));
+    CHECK(!fs::exists(dir / "m1.json.gz"));
+    fs::remove_all(dir);
+}
+
+}  // namespace
+
+int main() {
+    round_trip();
+    corrupt_file_is_dropped_and_replaced();
+    put_replaces_and_evict_removes();
+    return test_result();
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+// Shared by the parser tests: generated /v2/matches payloads, a field by
+// field MatchData comparison, and a guard that silences parser logging
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <nlohmann/json.hpp>
+#include "match_data.h"
+
+// A well-formed match payload with randomised stats. Names cover escapes,
+// multi-byte UTF-8 and runs longer than one SIMD block; entries carry keys
+// the parsers must skip (including a nested "total_kills"), some drop "dpr"
+// or send integers as floats, and `variant` switches the order of
+// stats/team_scores and pretty-printing.
+inline std::string make_match_payload(std::mt19937& rng, int variant) {
+    using nlohmann::json;
+    static const char* const kNames[] = {
+        "n", "Ünïcødé", "日本語", "🔥fire🔥", "a\"b", "tab\tname",
+        "plain name long enough to cross a 32 byte block",
+    };
+
+    json match;
+    match["id"] = "abc";
+    match["replay_url"] = "https://example.com/r?q=\"1\"\n";
+    match["extra"] = {{"a", {1, 2.5e3, nullptr, true, {{"stats", 3}}}}};
+
+    json stats = json::array();
+    size_t players = variant % 5 == 0 ? 13 : 10;
+    for (size_t i = 0; i < players; ++i) {
+        json entry = {
+            {"steam64_id", std::to_string(76561198000000000ULL + rng() % 1000000)},
+            {"name", std::string(kNames[rng() % std::size(kNames)]) + std::to_string(i)},
+            {"total_kills", static_cast<int>(rng() % 30)},
+            {"total_deaths", static_cast<int>(rng() % 30)},
+            {"total_assists", static_cast<int>(rng() % 10)},
+            {"kd_ratio", (rng() % 300) / 100.0},
+            {"initial_team_number", 2 + static_cast<int>(i % 2)},
+            {"dpr", (rng() % 15000) / 97.0},
+            {"total_hs_kills", static_cast<int>(rng() % 10)},
+            {"nested", {{"total_kills", 99}, {"x", {1, 2}}}},
+            {"flashbang_hit_foe", rng() % 7},
+            {"preaim", -static_cast<double>(rng() % 1000) / 7.0},
+        };
+        if (rng() % 5 == 0) entry.erase("dpr");
+        if (rng() % 9 == 0) entry["total_kills"] = static_cast<double>(rng() % 30);
+        stats.push_back(entry);
+    }
+    json team_scores = {
+        {{"team_number", 2}, {"score", static_cast<int>(rng() % 14)}},
+        {{"team_number", 3}, {"score", static_cast<int>(rng() % 14)}},
+    };
+
+    if (variant % 2) {
+        match["stats"] = stats;
+        match["team_scores"] = team_scores;
+    } else {
+        match["team_scores"] = team_scores;
+        match["stats"] = stats;
+    }
+    match["map_name"] = "de_dust2";
+    match["game_finished_at"] = "2024-01-01T00:00:00.000Z";
+    return variant % 3 == 0 ? match.dump(2) : match.dump();
+}
+
+// Everything a parse fills in (extended stats aside)
+inline bool same_match(const MatchData& a, const MatchData& b) {
+    if (a.match_id != b.match_id || a.map_name != b.map_name ||
+        a.game_finished_at != b.game_finished_at || a.players.size() != b.players.size() ||
+        a.team_scores.size() != b.team_scores.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.players.size(); ++i) {
+        PlayerStats x = a.players[i].to_stats();
+        PlayerStats y = b.players[i].to_stats();
+        if (x.steam_id != y.steam_id || x.name != y.name) return false;
+#define X(member, ...) \
+        if (x.member != y.member) return false;
+        PLAYER_STAT_FIELDS(X)
+#undef X
+    }
+    for (size_t i = 0; i < a.team_scores.size(); ++i) {
+        if (a.team_scores[i].team_number != b.team_scores[i].team_number ||
+            a.team_scores[i].score != b.team_scores[i].score) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The parsers log every call; keeps test output readable while alive
+class QuietLogs {
+public:
+    QuietLogs() {
+        std::cout.setstate(std::ios::failbit);
+        std::cerr.setstate(std::ios::failbit);
+    }
+    ~QuietLogs() {
+        std::cout.clear();
+        std::cerr.clear();
+    }
+    QuietLogs(const QuietLogs&) = delete;
+    QuietLogs& operator=(const QuietLogs&) = delete;
+};
@@ -0,0 +1,61 @@
+// PollScheduler: intervals after new matches, idle polls and failed fetches
+#include "check.h"
+#include "poll_scheduler.h"
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+const SteamId kPlayer(76561198000000001ULL);
+
+// base 60s, active 30s, max 480s
+PollScheduler make_scheduler(PollScheduler::Clock::time_point start) {
+    PollScheduler scheduler(60, 30, 480);
+    scheduler.add_player(kPlayer, start);
+    return scheduler;
+}
+
+void idle_polls_back_off() {
+    auto now = PollScheduler::Clock::time_point{};
+    PollScheduler scheduler = make_scheduler(now);
+
+    scheduler.record_poll(kPlayer, PollOutcome::NothingNew, now);
+    CHECK(scheduler.interval_for(kPlayer) == 120s);
+    scheduler.record_poll(kPlayer, PollOutcome::NothingNew, now);
+    scheduler.record_poll(kPlayer, PollOutcome::NothingNew, now);
+    scheduler.record_poll(kPlayer, PollOutcome::NothingNew, now);
+    CHECK(scheduler.interval_for(kPlayer) == 480s);
+
+    scheduler.record_poll(kPlayer, PollOutcome::NewMatch, now);
+    CHECK(scheduler.interval_for(kPlayer) == 30s);
+    CHECK(scheduler.next_due() == now + 30s);
+}
+
+void failed_fetch_retries_soon_without_backing_off() {
+    auto now = PollScheduler::Clock::time_point{};
+    PollScheduler scheduler = make_scheduler(now);
+    scheduler.record_poll(kPlayer, PollOutcome::NothingNew, now);
+    scheduler.record_poll(kPlayer, PollOutcome::NothingNew, now);
+    CHECK(scheduler.interval_for(kPlayer) == 240s);
+
+    CHECK(scheduler.pop_due(now + 240s).size() == 1);
+    now += 240s;
+    scheduler.record_poll(kPlayer, PollOutcome::FetchFailed, now);
+    CHECK(scheduler.interval_for(kPlayer) == 240s);
+    CHECK(scheduler.next_due() == now + 30s);
+
+    // Once the retry comes back empty, the backoff carries on from where it was
+    CHECK(scheduler.pop_due(now + 30s).size() == 1);
+    now += 30s;
+    scheduler.record_poll(kPlayer, PollOutcome::NothingNew, now);
+    CHECK(scheduler.interval_for(kPlayer) == 480s);
+}
+
+}  // namespace
+
+int main() {
+    idle_polls_back_off();
+    failed_fetch_retries_soon_without_backing_off();
+    return test_result();
+}
@@ -0,0 +1,67 @@
+// Roster: shared names are dropped with the last roster referencing them
+#include "check.h"
+#include "roster.h"
+#include <string>
+#include <utility>
+
+namespace {
+
+PlayerStats player(uint64_t steam_id, const std::string& name, int32_t kills) {
+    PlayerStats stats;
+    stats.steam_id = SteamId(steam_id);
+    stats.name = name;
+    stats.kills = kills;
+    return stats;
+}
+
+// A roster past the inline capacity, so the heap-backed columns are covered too
+Roster make_roster(const std::string& prefix, size_t players) {
+    Roster roster;
+    for (size_t i = 0; i < players; ++i) {
+        roster.push_back(player(76561198000000000ULL + i, prefix + std::to_string(i), static_cast<int32_t>(i)));
+    }
+    return roster;
+}
+
+void names_are_shared_and_dropped() {
+    CHECK(NameTable::global().size() == 0);
+    {
+        Roster first = make_roster("p", 4);
+        Roster second = make_roster("p", 4);
+        CHECK(NameTable::global().size() == 4);
+        CHECK(&first[2].name() == &second[2].name());
+    }
+    CHECK(NameTable::global().size() == 0);
+}
+
+void copies_and_moves_keep_names_alive() {
+    Roster original = make_roster("c", Roster::kInlinePlayers + 3);
+    const size_t players = original.size();
+    {
+        Roster copy = original;
+        Roster assigned;
+        assigned = copy;
+        Roster moved = std::move(copy);
+        CHECK(moved.size() == players);
+        CHECK(moved[players - 1].name() == "c" + std::to_string(players - 1));
+        CHECK(assigned[1].kills() == 1);
+    }
+    original = make_roster("d", 2);
+    CHECK(NameTable::global().size() == 2);
+    CHECK(original[1].name() == "d1");
+
+    original.clear();
+    CHECK(NameTable::global().size() == 0);
+    original.push_back(player(1, "again", 5));
+    CHECK(NameTable::global().size() == 1);
+    original = Roster();
+    CHECK(NameTable::global().size() == 0);
+}
+
+}  // namespace
+
+int main() {
+    names_are_shared_and_dropped();
+    copies_and_moves_keep_names_alive();
+    return test_result();
+}
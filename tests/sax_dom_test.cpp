@@ -0,0 +1,69 @@
+// parse_match_details_from_json (SAX) against the DOM reference implementation
+#include "check.h"
+#include "match_payloads.h"
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool parsers_agree(const std::string& body) {
+    MatchData sax;
+    MatchData dom;
+    {
+        QuietLogs quiet;
+        sax = parse_match_details_from_json(body, "m");
+        dom = parse_match_details_from_json_dom(body, "m");
+    }
+    if (same_match(sax, dom)) return true;
+    std::cerr << "parsers disagree on: " << body.substr(0, 200) << "\n";
+    return false;
+}
+
+void generated_payloads() {
+    std::mt19937 rng(1);
+    for (int variant = 0; variant < 300; ++variant) {
+        std::string body = make_match_payload(rng, variant);
+        CHECK(parsers_agree(body));
+    }
+}
+
+// Limited to documents the DOM reference reads without throwing (it rejects
+// a non-object root and wrongly typed values)
+void edge_cases() {
+    const std::vector<std::string> bodies = {
+        "",
+        "{bad",
+        "{}",
+        R"({"map_name":"de_nuke"})",
+        R"({"stats":[]})",
+        R"({"stats":{}})",
+        R"({"stats":[1,"x",null,{"name":"a","total_kills":3}]})",
+        // Repeated keys: the last one wins
+        R"({"stats":[{"total_kills":1,"total_kills":2}],"map_name":"a","map_name":"b"})",
+        R"({"stats":[{"name":"first"}],"stats":[{"name":"second"},{"name":"third"}]})",
+        R"({"stats":[{"name":"first"}],"stats":1})",
+        R"({"team_scores":[{"team_number":2,"score":1}],"stats":[{"initial_team_number":2}],)"
+        R"("team_scores":[{"team_number":2,"score":13},{"team_number":3,"score":4}]})",
+        // "stats" below the top level is not the roster
+        R"({"extra":{"stats":[{"name":"nested"}]},"stats":[{"name":"top"}]})",
+        R"({"stats":[{"total_kills":2.9,"total_deaths":-1,"kd_ratio":1,"dpr":0}]})",
+        // Floats outside the int64 range, in values nothing reads
+        R"({"extra":1e300,"stats":[{"name":"a","total_kills":3,"preaim":-1e300}]})",
+        R"({"stats":[{"steam64_id":"not a number","initial_team_number":3}],)"
+        R"("team_scores":[{"team_number":3,"score":13},{"team_number":2,"score":7}]})",
+        R"({"stats":[{"name":"é🔥"}]})",
+        R"({"stats":[]} trailing)",
+    };
+    for (const auto& body : bodies) {
+        CHECK(parsers_agree(body));
+    }
+}
+
+}  // namespace
+
+int main() {
+    generated_payloads();
+    edge_cases();
+    return test_result();
+}